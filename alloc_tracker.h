@@ -0,0 +1,76 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+// =====================================================
+// Heap allocation tracking
+// With WAVEBREAKER_TRACK_ALLOCATIONS defined, this header replaces the global
+// operator new/delete with counting versions, so it must be included by exactly
+// one translation unit (the game and the bench are each a single one). Without
+// the macro nothing is replaced and AllocationCount() stays 0.
+// SteadyStateCheck turns the counter into a per-frame assertion: once a state has
+// run for its warm-up frames, any allocation inside a checked frame is a violation.
+// =====================================================
+
+inline std::atomic<size_t>& AllocationCounter() {
+    static std::atomic<size_t> count{0};
+    return count;
+}
+
+inline size_t AllocationCount() { return AllocationCounter().load(std::memory_order_relaxed); }
+
+#ifdef WAVEBREAKER_TRACK_ALLOCATIONS
+constexpr bool allocationTrackingEnabled = true;
+
+void* operator new(size_t size) {
+    AllocationCounter().fetch_add(1, std::memory_order_relaxed);
+    if (void* p = malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](size_t size) { return operator new(size); }
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+#else
+constexpr bool allocationTrackingEnabled = false;
+#endif
+
+class SteadyStateCheck {
+public:
+    explicit SteadyStateCheck(int warmupFrames = 120) : warmupFrames(warmupFrames) {}
+
+    // Anything that legitimately grows storage (state change, new wave, resize) restarts the warm-up.
+    void Reset() { framesSinceReset = 0; }
+
+    void BeginFrame() { frameStart = AllocationCount(); }
+    // Returns the number of allocations charged against a steady frame (0 during warm-up).
+    size_t EndFrame() {
+        size_t allocations = AllocationCount() - frameStart;
+        if (framesSinceReset < warmupFrames) {
+            framesSinceReset++;
+            return 0;
+        }
+        framesChecked++;
+        if (allocations > 0) {
+            violations++;
+            violatingAllocations += allocations;
+        }
+        return allocations;
+    }
+
+    size_t FramesChecked() const { return framesChecked; }
+    size_t Violations() const { return violations; }
+    size_t ViolatingAllocations() const { return violatingAllocations; }
+
+private:
+    int warmupFrames;
+    int framesSinceReset = 0;
+    size_t frameStart = 0;
+    size_t framesChecked = 0;
+    size_t violations = 0;
+    size_t violatingAllocations = 0;
+};
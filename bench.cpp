@@ -0,0 +1,1568 @@
+// Headless benchmarks for the simulation hot paths.
+// Build (no window or GPU needed at runtime):
+//   g++ -std=c++14 -O2 -I<raylib>/src bench.cpp -o bench -lraylib -lm -lpthread -ldl
+// Run `bench` for the full report, or `bench --json [file]` for the scenario suite alone.
+// Phase timers are off by default so they don't skew the numbers; build with
+// -DFRAME_PROFILER=1 to add a per-phase breakdown to the scenario suite.
+#ifndef FRAME_PROFILER
+#define FRAME_PROFILER 0
+#endif
+#define WAVEBREAKER_TRACK_ALLOCATIONS
+#include "alloc_tracker.h"
+#include "game_sim.h"
+#include "draw_list.h"
+#include "fixed_timestep.h"
+#include "replay.h"
+#include "job_system.h"
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <new>
+
+// Checks that must hold (rather than just report) bump this; main returns non-zero if any failed.
+static int g_failures = 0;
+
+static double NowMs() {
+    using namespace std::chrono;
+    return duration<double, std::milli>(steady_clock::now().time_since_epoch()).count();
+}
+
+static float RandomRange(float lo, float hi) {
+    return lo + (hi - lo) * (static_cast<float>(rand()) / static_cast<float>(RAND_MAX));
+}
+
+static void FillField(GameSim& sim, int enemyCount, int bulletCount) {
+    sim.enemies.Clear();
+    sim.bullets.Clear();
+    if (bulletCount > GameSim::maxBullets) sim.bullets.SetCapacity(static_cast<size_t>(bulletCount));
+    for (int i = 0; i < enemyCount; i++) {
+        EnemyType type = static_cast<EnemyType>(i % 3);
+        sim.enemies.Push(Enemy(Vector2{RandomRange(0.f, sim.worldWidth), RandomRange(0.f, sim.worldHeight)}, type, 1,
+                               RandomRange(0.f, 2.f * PI)));
+    }
+    float speed = GameSim::baseBulletSpeed;
+    for (int i = 0; i < bulletCount; i++) {
+        Vector2 start = {RandomRange(0.f, sim.worldWidth), RandomRange(0.f, sim.worldHeight)};
+        float angle = RandomRange(-PI, PI);
+        sim.bullets.Push(Bullet(start, Vector2{cosf(angle) * speed, sinf(angle) * speed}, 20, YELLOW,
+                                (i % 16 == 0) ? ProjectileType::ROCKET : ProjectileType::BULLET));
+    }
+}
+
+// Bullet-vs-enemy broad phase: the old all-pairs scan against the grid query.
+static void BenchCollisionScaling() {
+    const int counts[] = {1000, 10000};
+    printf("collision broad phase (first-hit search per enemy)\n");
+    for (int enemyCount : counts) {
+        for (int bulletCount : counts) {
+            GameSim sim;
+            FillField(sim, enemyCount, bulletCount);
+            std::vector<int> naiveHits(sim.enemies.Size(), -1);
+            std::vector<int> gridHits(sim.enemies.Size(), -1);
+
+            double t0 = NowMs();
+            for (size_t i = 0; i < sim.enemies.Size(); i++) {
+                Vector2 enemyPos = sim.enemies.Position(i);
+                float enemyRadius = sim.enemies.radius[i];
+                for (size_t j = 0; j < sim.bullets.Size(); j++) {
+                    const Bullet& bullet = sim.bullets[j];
+                    if (SweptCircleHit(bullet.previousPosition, bullet.position, bullet.radius, enemyPos, enemyRadius)) {
+                        naiveHits[i] = static_cast<int>(j);
+                        break;
+                    }
+                }
+            }
+            double naiveMs = NowMs() - t0;
+
+            t0 = NowMs();
+            sim.BuildBulletGrid();
+            for (size_t i = 0; i < sim.enemies.Size(); i++) {
+                gridHits[i] = sim.FindBulletHit(sim.enemies.Position(i), sim.enemies.radius[i]);
+            }
+            double gridMs = NowMs() - t0;
+
+            bool match = naiveHits == gridHits;
+            if (!match) g_failures++;
+            printf("  %6d enemies x %6d bullets: naive %9.3f ms  grid %7.3f ms  speedup %6.1fx  %s\n",
+                   enemyCount, bulletCount, naiveMs, gridMs, naiveMs / (gridMs > 0.0 ? gridMs : 1e-6),
+                   match ? "match" : "MISMATCH");
+        }
+    }
+}
+
+// Thousands of enemies dying in one frame: one rocket blast over a packed cluster.
+// Removal is a single stable compaction, so cost per death should stay flat as N grows.
+// The old erase-in-loop pattern is timed on a copy for comparison (skipped when it would take seconds).
+static void BenchMassDeath() {
+    const int counts[] = {1000, 4000, 16000, 64000};
+    printf("mass death (one explosion kills every enemy)\n");
+    for (int count : counts) {
+        GameSim sim;
+        // The pile is one dense blob, so separation would dominate the step; time kills and compaction.
+        sim.crowdSeparation = false;
+        std::vector<Enemy> reference;
+        reference.reserve(static_cast<size_t>(count));
+        for (int i = 0; i < count; i++) {
+            float angle = RandomRange(0.f, 2.f * PI);
+            float dist = RandomRange(0.f, 90.f);
+            reference.emplace_back(Vector2{150.f + cosf(angle) * dist, 150.f + sinf(angle) * dist},
+                                   EnemyType::GRUNT, 1, RandomRange(0.f, 2.f * PI));
+        }
+        sim.enemies.Reserve(reference.size());
+        for (auto &enemy : reference) sim.enemies.Push(enemy);
+        sim.enemiesRemaining = count;
+        sim.explosions.push_back(Explosion{{150.f, 150.f}, 110.f, 0.35f, 0.f, 1000000, false});
+
+        double t0 = NowMs();
+        sim.Step(InputFrame{}, 1.f / 60.f);
+        double stepMs = NowMs() - t0;
+
+        double eraseMs = -1.0;
+        if (count <= 16000) {
+            t0 = NowMs();
+            for (int idx = 0; idx < (int)reference.size();) {
+                reference.erase(reference.begin() + idx);
+            }
+            eraseMs = NowMs() - t0;
+        }
+
+        printf("  %6d deaths: step %8.3f ms (%6.1f ns/death, %zu left)",
+               count, stepMs, stepMs * 1e6 / count, sim.enemies.Size());
+        if (eraseMs >= 0.0) printf("  per-element erase %9.3f ms\n", eraseMs);
+        else printf("  per-element erase skipped\n");
+    }
+}
+
+// SoA movement kernel on 100k enemies: the SIMD path against the scalar fallback.
+static void BenchEnemyKernel() {
+    const int count = 100000;
+    const int frames = 200;
+    EnemyStore simd;
+    simd.Reserve(count);
+    for (int i = 0; i < count; i++) {
+        EnemyType type = static_cast<EnemyType>(i % 3);
+        simd.Push(Enemy(Vector2{RandomRange(-60.f, 1060.f), RandomRange(-60.f, 1060.f)}, type, 1 + i % 40,
+                        RandomRange(0.f, 2.f * PI)));
+    }
+    EnemyStore scalar = simd;
+    Vector2 playerPos = {500.f, 500.f};
+    float delta = 1.f / 120.f;
+
+    double t0 = NowMs();
+    for (int f = 0; f < frames; f++) UpdateEnemyMovement(simd, 0, simd.Size(), playerPos, delta);
+    double simdMs = (NowMs() - t0) / frames;
+
+    t0 = NowMs();
+    for (int f = 0; f < frames; f++) UpdateEnemyMovementScalar(scalar, 0, scalar.Size(), playerPos, delta);
+    double scalarMs = (NowMs() - t0) / frames;
+
+    bool identical = simd.posX == scalar.posX && simd.posY == scalar.posY &&
+                     simd.facingX == scalar.facingX && simd.facingY == scalar.facingY &&
+                     simd.timer == scalar.timer;
+#if defined(ENEMY_KERNEL_AVX2)
+    const char* path = "avx2";
+#elif defined(ENEMY_KERNEL_SSE2)
+    const char* path = "sse2";
+#else
+    const char* path = "scalar";
+#endif
+    if (!identical) g_failures++;
+    printf("enemy movement kernel (%d enemies, %s)\n", count, path);
+    printf("  dispatch %.3f ms/frame  scalar %.3f ms/frame  %s\n",
+           simdMs, scalarMs, identical ? "bit-identical" : "MISMATCH");
+}
+
+// Enemy movement split into GameSim::enemyMoveChunk jobs on the work-stealing pool, for
+// several thread counts. Every run must match the serial pass bit for bit, both for the
+// kernel alone and for full Steps over a crowded field (compared by state checksum).
+static void BenchJobSystem() {
+    const int count = 100000;
+    const int frames = 200;
+    EnemyStore reference;
+    reference.Reserve(count);
+    for (int i = 0; i < count; i++) {
+        EnemyType type = static_cast<EnemyType>(i % 3);
+        reference.Push(Enemy(Vector2{RandomRange(-60.f, 1060.f), RandomRange(-60.f, 1060.f)}, type, 1 + i % 40,
+                             RandomRange(0.f, 2.f * PI)));
+    }
+    EnemyStore start = reference;
+    Vector2 playerPos = {500.f, 500.f};
+    float delta = 1.f / 120.f;
+    double t0 = NowMs();
+    for (int f = 0; f < frames; f++) UpdateEnemyMovement(reference, 0, reference.Size(), playerPos, delta);
+    double serialMs = (NowMs() - t0) / frames;
+
+    GameSim field;
+    field.enemiesRemaining = 1 << 30;
+    field.powerUpSpawnTimer = 1e9f;
+    FillField(field, 20000, 1000);
+    InputFrame input;
+    input.fire = true;
+    input.aim = {900.f, 500.f};
+    GameSim serialSim = field;
+    for (int f = 0; f < 120; f++) serialSim.Step(input, delta);
+    uint64_t serialChecksum = serialSim.StateChecksum();
+
+    printf("job system enemy movement (%d enemies, %zu per chunk, serial %.3f ms/frame)\n", count,
+           GameSim::enemyMoveChunk, serialMs);
+    int threadCounts[] = {1, 2, 4, 8};
+    for (int threads : threadCounts) {
+        JobSystem jobs(threads);
+        EnemyStore store = start;
+        auto move = [&](size_t begin, size_t end) { UpdateEnemyMovement(store, begin, end, playerPos, delta); };
+        size_t allocsBefore = AllocationCount();
+        t0 = NowMs();
+        for (int f = 0; f < frames; f++) jobs.ParallelFor(0, store.Size(), GameSim::enemyMoveChunk, move);
+        double ms = (NowMs() - t0) / frames;
+        size_t allocs = AllocationCount() - allocsBefore;
+        bool identical = store.posX == reference.posX && store.posY == reference.posY &&
+                         store.facingX == reference.facingX && store.facingY == reference.facingY &&
+                         store.timer == reference.timer;
+
+        GameSim sim = field;
+        sim.jobs = &jobs;
+        for (int f = 0; f < 120; f++) sim.Step(input, delta);
+        bool stepsMatch = sim.StateChecksum() == serialChecksum;
+        if (!identical || !stepsMatch || allocs != 0) g_failures++;
+
+        printf("  %d thread%s %.3f ms/frame (%.2fx)  steals %llu  heap allocations %zu  kernel %s  20k-enemy steps %s\n",
+               threads, threads == 1 ? " " : "s", ms, serialMs / ms, static_cast<unsigned long long>(jobs.Steals()),
+               allocs, identical ? "bit-identical" : "MISMATCH", stepsMatch ? "identical" : "MISMATCH");
+    }
+}
+
+// Narrow phase over 20k enemies and 10k bullets: the pairs gathered on 1..8 threads must
+// come back in exactly the serial order, and steady-state gathering must not allocate.
+// Every line is compared with the serial first-hit search that Step uses on one thread
+// or a small roster; speedups need as many cores as threads. The one-thread ratio gives
+// the pool size where gathering breaks even, which GameSim::parallelCollisionMinThreads
+// should not undercut.
+static void BenchParallelCollision() {
+    const int frames = 50;
+    GameSim sim;
+    FillField(sim, 20000, 10000);
+    sim.BuildBulletGrid();
+    std::vector<uint64_t> serialKeys;
+    sim.GatherCollisions(serialKeys);
+    std::vector<uint64_t> keys;
+
+    // The serial path: one first-hit search per enemy, which Step resolves as it goes.
+    size_t serialHits = 0;
+    double t0 = NowMs();
+    for (int f = 0; f < frames; f++) {
+        for (size_t i = 0; i < sim.enemies.Size(); i++) {
+            Vector2 enemyPos = sim.enemies.Position(i);
+            float enemyRadius = sim.enemies.radius[i];
+            if (CheckCollisionCircles(sim.player.position, sim.player.radius, enemyPos, enemyRadius) ||
+                sim.FindBulletHit(enemyPos, enemyRadius) >= 0) serialHits++;
+        }
+    }
+    double searchMs = (NowMs() - t0) / frames;
+    printf("parallel collision narrow phase (20000 enemies x 10000 bullets, %zu pairs, %zu enemies per job)\n",
+           serialKeys.size(), GameSim::collisionChunk);
+    printf("  serial first-hit search %.3f ms (%zu enemies hit, %u hardware threads)\n", searchMs, serialHits / frames,
+           std::thread::hardware_concurrency());
+    int threadCounts[] = {1, 2, 4, 8};
+    bool ok = true;
+    for (int threads : threadCounts) {
+        JobSystem jobs(threads);
+        sim.jobs = &jobs;
+        sim.GatherCollisions(keys);  // sizes the per-thread buffers
+        size_t allocsBefore = AllocationCount();
+        double t0 = NowMs();
+        for (int f = 0; f < frames; f++) sim.GatherCollisions(keys);
+        double ms = (NowMs() - t0) / frames;
+        size_t allocs = AllocationCount() - allocsBefore;
+        bool same = keys == serialKeys;
+        ok &= same && allocs == 0;
+        printf("  %d thread%s gather %.3f ms (%.2fx serial)  heap allocations %zu  %s  Step uses %s\n", threads,
+               threads == 1 ? " " : "s", ms, searchMs / ms, allocs, same ? "same order" : "MISMATCH",
+               sim.ParallelCollisions() ? "gather" : "serial");
+        if (threads == 1) {
+            // With one core per thread the gather splits evenly, so it wins once threads * serial > gather.
+            int breakEven = static_cast<int>(std::floor(ms / searchMs)) + 1;
+            printf("  break-even at %d threads, Step gathers from %d  %s\n", breakEven,
+                   GameSim::parallelCollisionMinThreads,
+                   breakEven <= GameSim::parallelCollisionMinThreads ? "ok" : "RAISE THRESHOLD");
+        }
+        sim.jobs = nullptr;
+    }
+    if (!ok) g_failures++;
+}
+
+// Sustained rapid fire + spread shot at the 0.05 s cooldown floor with a sweeping aim.
+// After warm-up the projectile pool must not touch the heap at all.
+static void BenchBulletPool() {
+    const int warmupFrames = 600;
+    const int frames = 6000;
+    GameSim sim;
+    sim.permanentFireRateMultiplier = 4.f;
+    sim.enemiesRemaining = 1;
+    sim.powerUpSpawnTimer = 1e9f;
+    sim.GrantPowerUp(PowerUpType::RAPID_FIRE, 1e9f);
+    sim.GrantPowerUp(PowerUpType::SPREAD_SHOT, 1e9f);
+    InputFrame input;
+    input.fire = true;
+    float delta = 1.f / 60.f;
+
+    auto aimAt = [&](int frame) {
+        float angle = static_cast<float>(frame) * 0.05f;
+        input.aim = {sim.player.position.x + cosf(angle) * 300.f, sim.player.position.y + sinf(angle) * 300.f};
+    };
+    for (int f = 0; f < warmupFrames; f++) {
+        aimAt(f);
+        sim.Step(input, delta);
+    }
+    size_t allocsBefore = AllocationCount();
+    double t0 = NowMs();
+    for (int f = 0; f < frames; f++) {
+        aimAt(warmupFrames + f);
+        sim.Step(input, delta);
+    }
+    double stepMs = (NowMs() - t0) / frames;
+    size_t allocs = AllocationCount() - allocsBefore;
+    if (allocs != 0) g_failures++;
+
+    printf("bullet pool (rapid fire + spread, %d frames after %d warm-up)\n", frames, warmupFrames);
+    printf("  capacity %zu  high-water %zu  dropped %zu  live %zu  %.4f ms/frame  heap allocations %zu  %s\n",
+           sim.bullets.Capacity(), sim.bullets.HighWater(), sim.bullets.Dropped(), sim.bullets.Size(),
+           stepMs, allocs, allocs == 0 ? "ok" : "ALLOCATED");
+}
+
+// Spawning through the per-wave archetype table against scaling every enemy on its own;
+// both must produce the same health and speed streams.
+static void BenchArchetypeSpawn() {
+    const int count = 100000;
+    const int wave = 25;
+    EnemyStore scaled, table;
+    scaled.Reserve(count);
+    table.Reserve(count);
+    double t0 = NowMs();
+    for (int i = 0; i < count; i++) scaled.Push(Enemy({0.f, 0.f}, static_cast<EnemyType>(i % 3), wave, 0.f));
+    double scaledMs = NowMs() - t0;
+    t0 = NowMs();
+    EnemyWaveStats stats = ScaleEnemyArchetypes(wave);
+    for (int i = 0; i < count; i++) table.Push(Enemy({0.f, 0.f}, static_cast<EnemyType>(i % 3), stats, 0.f));
+    double tableMs = NowMs() - t0;
+    bool same = scaled.health == table.health && scaled.speed == table.speed && scaled.radius == table.radius;
+    if (!same) g_failures++;
+    printf("enemy archetypes (%d spawns at wave %d, sizeof(Enemy) %zu)\n", count, wave, sizeof(Enemy));
+    printf("  scale per enemy %.3f ms  per-wave table %.3f ms  %s\n", scaledMs, tableMs, same ? "same stats" : "MISMATCH");
+}
+
+// A horde wave placed in one step against the same wave streamed in by the budgeted
+// spawner: the streamed version must spread the spawn cost over many steps, and
+// enemiesRemaining must always equal the alive plus the still-pending enemies.
+static void BenchHordeSpawn() {
+    const int wave = 60;
+    const int steps = 240;
+    const float delta = 1.f / 120.f;
+    printf("horde spawner (wave %d, 20000 alive cap, first %d steps)\n", wave, steps);
+    int perStepBudgets[] = {20000, 256};
+    for (int budget : perStepBudgets) {
+        GameSim sim;
+        sim.horde.enabled = true;
+        sim.horde.spawnPerStep = budget;
+        sim.currentWave = wave;
+        sim.SpawnWave(wave);
+        int total = sim.enemiesRemaining;
+        InputFrame input;
+        double firstMs = 0.0, worstMs = 0.0, sumMs = 0.0;
+        int worstStep = 0;
+        bool consistent = true;
+        for (int f = 0; f < steps; f++) {
+            sim.player.health = sim.player.maxHealth;
+            double t0 = NowMs();
+            sim.Step(input, delta);
+            double ms = NowMs() - t0;
+            sumMs += ms;
+            if (f == 0) firstMs = ms;
+            if (ms > worstMs) {
+                worstMs = ms;
+                worstStep = f;
+            }
+            consistent &= sim.enemiesRemaining == static_cast<int>(sim.enemies.Size()) + sim.pendingSpawns;
+        }
+        if (!consistent) g_failures++;
+        printf("  %5d per step: first %7.3f ms  worst %7.3f ms (step %3d)  mean %.3f ms  %zu alive, %d pending of %d  %s\n",
+               budget, firstMs, worstMs, worstStep, sumMs / steps, sim.enemies.Size(), sim.pendingSpawns, total,
+               consistent ? "ok" : "COUNT MISMATCH");
+    }
+}
+
+// Flow-field steering. In an open arena the field only compares cells and enemies must
+// keep their exact beeline; with a wall the rebuild cost is measured as the player
+// crosses cells, and a crowd released behind the wall must reach the player through the
+// gap. Grunts and tanks, which steer without sway, must never enter a wall cell.
+static void BenchFlowField() {
+    const float width = 1920.f, height = 1080.f;
+    const int updates = 20000;
+    printf("flow field (%.0fx%.0f, %.0f px cells)\n", width, height, GameSim::flowCellSize);
+
+    FlowField field;
+    field.Reset(width, height, GameSim::flowCellSize);
+    auto orbit = [&](int u) {
+        float angle = static_cast<float>(u) * 0.002f;
+        return Vector2{width * 0.5f + std::cos(angle) * 400.f, height * 0.5f + std::sin(angle) * 300.f};
+    };
+    double t0 = NowMs();
+    for (int u = 0; u < updates; u++) field.Update(orbit(u));
+    double openUs = (NowMs() - t0) * 1000.0 / updates;
+    int openRebuilds = field.Rebuilds();
+
+    EnemyStore straight;
+    for (int i = 0; i < 256; i++) {
+        straight.Push(Enemy(Vector2{RandomRange(0.f, width), RandomRange(0.f, height)}, static_cast<EnemyType>(i % 3), 1,
+                            RandomRange(0.f, 2.f * PI)));
+    }
+    EnemyStore routed = straight;
+    std::vector<float> targetX(straight.Size()), targetY(straight.Size());
+    Vector2 playerPos = {width * 0.5f, height * 0.5f};
+    field.Update(playerPos);
+    for (int f = 0; f < 240; f++) {
+        UpdateEnemyMovement(straight, 0, straight.Size(), playerPos, 1.f / 120.f);
+        for (size_t i = 0; i < routed.Size(); i++) {
+            Vector2 target = field.Target(routed.Position(i), playerPos);
+            targetX[i] = target.x;
+            targetY[i] = target.y;
+        }
+        UpdateEnemyMovement(routed, 0, routed.Size(), playerPos, 1.f / 120.f, targetX.data(), targetY.data());
+    }
+    bool beeline = straight.posX == routed.posX && straight.posY == routed.posY;
+    if (!beeline) g_failures++;
+    printf("  open arena: %.3f us/update  %d rebuilds in %d updates  beeline %s\n", openUs, openRebuilds, updates,
+           beeline ? "bit-identical" : "MISMATCH");
+
+    // A wall down the middle with a gap at the bottom, and a shelf jutting out from it.
+    field.SetBlocked({944.f, 0.f, 32.f, 800.f});
+    field.SetBlocked({640.f, 384.f, 300.f, 32.f});
+    int before = field.Rebuilds();
+    t0 = NowMs();
+    for (int u = 0; u < updates; u++) field.Update(orbit(u));
+    int walledRebuilds = field.Rebuilds() - before;
+    double walledUs = (NowMs() - t0) * 1000.0 / std::max(1, walledRebuilds);
+
+    EnemyStore crowd;
+    RngStream rng(41, 0);
+    for (int i = 0; i < 600; i++) {
+        crowd.Push(Enemy(Vector2{100.f + rng.Unit() * 500.f, 100.f + rng.Unit() * 600.f}, static_cast<EnemyType>(i % 3), 1,
+                         rng.Unit() * 2.f * PI));
+    }
+    targetX.assign(crowd.Size(), 0.f);
+    targetY.assign(crowd.Size(), 0.f);
+    playerPos = {1500.f, 300.f};
+    field.Update(playerPos);
+    const uint8_t runnerCode = static_cast<uint8_t>(EnemyType::RUNNER);
+    size_t steadyInWall = 0, runnerInWall = 0;
+    for (int f = 0; f < 120 * 40; f++) {
+        for (size_t i = 0; i < crowd.Size(); i++) {
+            Vector2 target = field.Target(crowd.Position(i), playerPos);
+            targetX[i] = target.x;
+            targetY[i] = target.y;
+        }
+        UpdateEnemyMovement(crowd, 0, crowd.Size(), playerPos, 1.f / 120.f, targetX.data(), targetY.data());
+        for (size_t i = 0; i < crowd.Size(); i++) {
+            if (!field.Blocked(crowd.Position(i))) continue;
+            if (crowd.type[i] == runnerCode) runnerInWall++;
+            else steadyInWall++;
+        }
+    }
+    size_t arrived = 0;
+    for (size_t i = 0; i < crowd.Size(); i++) {
+        if (Vector2Distance(crowd.Position(i), playerPos) < 48.f) arrived++;
+    }
+    bool routedOk = steadyInWall == 0 && arrived == crowd.Size();
+    if (!routedOk) g_failures++;
+    printf("  walled: %.1f us/rebuild (%d rebuilds)  %zu/%zu reached the player in 40 s  wall-cell steps: %zu steady, %zu runner  %s\n",
+           walledUs, walledRebuilds, arrived, crowd.Size(), steadyInWall, runnerInWall, routedOk ? "ok" : "FAIL");
+}
+
+// Full Steps over a growing crowd on a fixed 1920x1080 field, so density rises with the
+// count. Separation samples a capped number of neighbours per cell, so the cost per enemy
+// must stay flat: the 20k crowd may cost at most twice as much per enemy as 2.5k. A tight
+// pile must also spread out: the summed overlap has to drop to under a fifth within 4 s.
+static void BenchCrowdSeparation() {
+    const int counts[] = {2500, 5000, 10000, 20000};
+    const int steps = 30;
+    const float delta = 1.f / 120.f;
+    printf("crowd separation (1920x1080, %d neighbours sampled per cell)\n", GameSim::separationCellCap);
+    EnemyWaveStats stats = ScaleEnemyArchetypes(1);
+    auto totalOverlap = [](const EnemyStore& store) {
+        double overlap = 0.0;
+        for (size_t i = 0; i < store.Size(); i++) {
+            for (size_t j = i + 1; j < store.Size(); j++) {
+                float depth = store.radius[i] + store.radius[j] - Vector2Distance(store.Position(i), store.Position(j));
+                if (depth > 0.f) overlap += depth;
+            }
+        }
+        return overlap;
+    };
+
+    double baseNs = 0.0;
+    bool linear = true;
+    for (int count : counts) {
+        GameSim sim;
+        sim.SetWorldSize(1920.f, 1080.f);
+        sim.player.position = {960.f, 540.f};
+        sim.enemies.Reserve(static_cast<size_t>(count));
+        RngStream rng(51, 0);
+        while (static_cast<int>(sim.enemies.Size()) < count) {
+            Vector2 pos = {rng.Unit() * 1920.f, rng.Unit() * 1080.f};
+            if (Vector2Distance(pos, sim.player.position) < 200.f) continue;  // nobody reaches the player in time
+            sim.enemies.Push(Enemy(pos, static_cast<EnemyType>(sim.enemies.Size() % 3), stats, rng.Unit() * 2.f * PI));
+        }
+        sim.enemiesRemaining = count;
+        InputFrame input;
+        sim.Step(input, delta);
+        double t0 = NowMs();
+        for (int f = 0; f < steps; f++) sim.Step(input, delta);
+        double ns = (NowMs() - t0) * 1e6 / steps / count;
+        if (baseNs == 0.0) baseNs = ns;
+        bool flat = ns <= baseNs * 2.0;
+        linear &= flat;
+        printf("  %5d enemies: %.3f ms/step  %.1f ns/enemy  %s\n", count, ns * count * 1e-6, ns,
+               flat ? "ok" : "NOT LINEAR");
+    }
+    if (!linear) g_failures++;
+
+    GameSim sim;
+    sim.SetWorldSize(1920.f, 1080.f);
+    sim.player.position = {1700.f, 540.f};
+    RngStream rng(52, 0);
+    for (int i = 0; i < 400; i++) {
+        Vector2 pos = {200.f + rng.Unit() * 60.f, 540.f + rng.Unit() * 60.f};
+        sim.enemies.Push(Enemy(pos, EnemyType::GRUNT, stats, 0.f));
+    }
+    sim.enemies.Push(Enemy(sim.enemies.Position(0), EnemyType::GRUNT, stats, 0.f));  // exactly stacked
+    sim.enemiesRemaining = static_cast<int>(sim.enemies.Size());
+    double before = totalOverlap(sim.enemies);
+    InputFrame input;
+    for (int f = 0; f < 480; f++) sim.Step(input, delta);
+    double after = totalOverlap(sim.enemies);
+    bool spread = after < before * 0.2;
+    if (!spread) g_failures++;
+    printf("  pile of %zu: summed overlap %.0f px -> %.0f px after 4 s  %s\n", sim.enemies.Size(), before, after,
+           spread ? "ok" : "DID NOT SPREAD");
+}
+
+// fast_math.h against double-precision libm, at the error bounds its header documents:
+// sin/cos within 1e-6 up to 2pi and 1.5e-7 * |x| out to 64pi, atan2 within 3e-6 rad at
+// every angle and scale, the spread rotations against cos/sin of the offset angle, and
+// the batch forms bit-identical to the scalar ones. Also times the batches against libm.
+static void BenchFastMath() {
+    const int count = 1 << 20;
+    std::vector<float> angles(count), ys(count), xs(count);
+    std::vector<float> sinOut(count), cosOut(count), atanOut(count);
+    RngStream rng(61, 0);
+    for (int i = 0; i < count; i++) {
+        angles[i] = (rng.Unit() * 2.f - 1.f) * 64.f * PI;
+        float scale = std::pow(10.f, rng.Unit() * 8.f - 4.f);
+        ys[i] = (rng.Unit() * 2.f - 1.f) * scale;
+        xs[i] = (rng.Unit() * 2.f - 1.f) * scale;
+    }
+
+    double sinError = 0.0, wideError = 0.0, atanError = 0.0;
+    bool sinOk = true;
+    for (int i = -1000000; i <= 1000000; i++) {
+        float x = static_cast<float>(i) * (64.f * PI / 1000000.f);
+        double error = std::max(std::fabs(FastSin(x) - std::sin(static_cast<double>(x))),
+                                std::fabs(FastCos(x) - std::cos(static_cast<double>(x))));
+        if (std::fabs(x) <= 2.f * PI) sinError = std::max(sinError, error);
+        else wideError = std::max(wideError, error / std::fabs(x));
+        sinOk &= error <= std::max(1e-6, 1.5e-7 * std::fabs(x));
+    }
+    for (int i = 0; i < count; i++) {
+        atanError = std::max(atanError, std::fabs(FastAtan2(ys[i], xs[i]) -
+                                                  std::atan2(static_cast<double>(ys[i]), static_cast<double>(xs[i]))));
+    }
+    bool atanOk = atanError <= 3e-6 && FastAtan2(0.f, 0.f) == 0.f && FastAtan2(0.f, -1.f) > 0.f &&
+                  FastAtan2(-0.f, -1.f) < 0.f && FastAtan2(1.f, 0.f) == kHalfPi && FastAtan2(-1.f, 0.f) == -kHalfPi;
+
+    double rotateError = 0.0;
+    UnitRotation spread[] = {MakeUnitRotation(0.18f), MakeUnitRotation(-0.18f)};
+    const float offsets[] = {0.18f, -0.18f};
+    for (int i = 0; i < 4096; i++) {
+        double base = static_cast<double>(i) * (2.0 * PI / 4096.0);
+        Vector2 aim = {static_cast<float>(std::cos(base)), static_cast<float>(std::sin(base))};
+        for (int k = 0; k < 2; k++) {
+            Vector2 turned = Rotate(aim, spread[k]);
+            double angle = base + offsets[k];
+            rotateError = std::max(rotateError, std::max(std::fabs(turned.x - std::cos(angle)),
+                                                         std::fabs(turned.y - std::sin(angle))));
+        }
+    }
+    bool rotateOk = rotateError <= 1e-6;
+
+    float sink = 0.f;
+    double t0 = NowMs();
+    for (int i = 0; i < count; i++) sink += sinf(angles[i]) + cosf(angles[i]);
+    double libSinCosMs = NowMs() - t0;
+    t0 = NowMs();
+    FastSinCosBatch(angles.data(), sinOut.data(), cosOut.data(), count);
+    double fastSinCosMs = NowMs() - t0;
+    t0 = NowMs();
+    for (int i = 0; i < count; i++) sink += atan2f(ys[i], xs[i]);
+    double libAtanMs = NowMs() - t0;
+    t0 = NowMs();
+    FastAtan2Batch(ys.data(), xs.data(), atanOut.data(), count);
+    double fastAtanMs = NowMs() - t0;
+
+    bool batchOk = true;
+    for (int i = 0; i < count; i++) {
+        batchOk &= sinOut[i] == FastSin(angles[i]) && cosOut[i] == FastCos(angles[i]) &&
+                   atanOut[i] == FastAtan2(ys[i], xs[i]);
+    }
+    if (!(sinOk && atanOk && rotateOk && batchOk)) g_failures++;
+    printf("fast math (%d values, errors vs double libm)\n", count);
+    printf("  sin/cos  max %.2g up to 2pi, %.2g * |x| to 64pi  batch %.2f ms vs libm %.2f ms  %s\n",
+           sinError, wideError, fastSinCosMs, libSinCosMs, sinOk ? "within bounds" : "OUT OF BOUNDS");
+    printf("  atan2    max %.2g rad  batch %.2f ms vs libm %.2f ms  %s\n", atanError, fastAtanMs, libAtanMs,
+           atanOk ? "within bounds" : "OUT OF BOUNDS");
+    printf("  spread rotation max %.2g  batches %s  (sink %.1f)\n", rotateError,
+           batchOk ? "match scalar" : "MISMATCH", sink + sinOut[count / 2] + atanOut[count / 3]);
+}
+
+// Fast projectiles at low tick rates: every lane fires one bullet or rocket at a RUNNER
+// (radius 12) from just in front of it, and most steps carry the shot clean past the
+// enemy, where the end position alone would miss. Every shot must still register. Also checks the
+// SIMD batch test against the scalar one and times both.
+static void BenchSweptCollision() {
+    const int lanes = 64;
+    const float enemyX = 1000.f;
+    printf("swept projectile collision (RUNNER radius %.0f)\n", GetEnemyArchetype(EnemyType::RUNNER).radius);
+    bool allHit = true;
+    struct Rate { float hz; float speed; };
+    const Rate rates[] = {{120.f, GameSim::baseBulletSpeed}, {30.f, 2400.f}, {15.f, 2400.f}};
+    for (const Rate& rate : rates) {
+        GameSim sim;
+        sim.SetWorldSize(2000.f, 1400.f);
+        sim.player.position = {60.f, 700.f};
+        EnemyWaveStats stats = ScaleEnemyArchetypes(1);
+        int endPointHits = 0;
+        float travel = rate.speed / rate.hz;
+        for (int lane = 0; lane < lanes; lane++) {
+            float y = 40.f + static_cast<float>(lane) * 20.f;
+            sim.enemies.Push(Enemy(Vector2{enemyX, y}, EnemyType::RUNNER, stats, 0.f));
+            // Every step crosses x = enemyX - 16 (inside the reach); the starts spread over one
+            // step, so the end positions land anywhere from there to a full step past the enemy.
+            float start = enemyX - 16.f - travel * static_cast<float>(lane) / lanes;
+            bool rocket = lane % 8 == 0;
+            sim.bullets.Push(Bullet(Vector2{start, y}, Vector2{rate.speed, 0.f}, 1, YELLOW,
+                                    rocket ? ProjectileType::ROCKET : ProjectileType::BULLET,
+                                    rocket ? 1.f : 0.f));
+            float reach = GetEnemyArchetype(EnemyType::RUNNER).radius + (rocket ? 8.f : 5.f);
+            if (std::fabs(start + travel - enemyX) <= reach) endPointHits++;
+        }
+        sim.enemiesRemaining = lanes;
+        InputFrame input;
+        SimEvents events = sim.Step(input, 1.f / rate.hz);
+        allHit &= events.enemyHits == lanes;
+        printf("  %5.0f Hz, %4.0f px/s (%5.1f px/step): %2d/%d hits  end-point test would catch %2d  %s\n", rate.hz,
+               rate.speed, travel, events.enemyHits, lanes, endPointHits, events.enemyHits == lanes ? "ok" : "MISSED");
+    }
+
+    const size_t slots = 8192;
+    const int circles = 2048;
+    ProjectileSweeps sweeps;
+    sweeps.Resize(slots);
+    RngStream rng(71, 0);
+    for (size_t k = 0; k < slots; k++) {
+        Vector2 from = {rng.Unit() * 512.f, rng.Unit() * 512.f};
+        Vector2 to = {from.x + (rng.Unit() - 0.5f) * 80.f, from.y + (rng.Unit() - 0.5f) * 80.f};
+        sweeps.Set(k, from, to, k % 16 == 0 ? 8.f : 5.f);
+    }
+    std::vector<Vector2> centers(circles);
+    for (auto& center : centers) center = {rng.Unit() * 512.f, rng.Unit() * 512.f};
+    size_t batchHits = 0, scalarHits = 0;
+    bool same = true;
+    double t0 = NowMs();
+    for (const Vector2& center : centers) {
+        for (size_t k = 0; k < slots; k += ProjectileSweeps::batchWidth) {
+            batchHits += static_cast<size_t>(__builtin_popcount(sweeps.Hits(k, ProjectileSweeps::batchWidth, center, 12.f)));
+        }
+    }
+    double batchMs = NowMs() - t0;
+    t0 = NowMs();
+    for (const Vector2& center : centers) {
+        for (size_t k = 0; k < slots; k++) scalarHits += sweeps.Hit(k, center, 12.f) ? 1 : 0;
+    }
+    double scalarMs = NowMs() - t0;
+    for (int c = 0; c < 64; c++) {
+        for (size_t k = 0; k < slots; k += 5) {
+            size_t width = std::min<size_t>(5, slots - k);
+            uint32_t mask = sweeps.Hits(k, width, centers[static_cast<size_t>(c)], 12.f);
+            for (size_t b = 0; b < width; b++) same &= ((mask >> b) & 1u) == (sweeps.Hit(k + b, centers[static_cast<size_t>(c)], 12.f) ? 1u : 0u);
+        }
+    }
+    same &= batchHits == scalarHits;
+    if (!allHit || !same) g_failures++;
+    double tests = static_cast<double>(slots) * circles;
+    printf("  batch test %.2f ns/step  scalar %.2f ns/step  %zu hits  %s\n", batchMs * 1e6 / tests,
+           scalarMs * 1e6 / tests, batchHits, same ? "match" : "MISMATCH");
+}
+
+// 48 stacked timed effects with a refresh every 60 frames, against the old pattern of
+// decrementing every remaining time and rebuilding the stats each frame. Idle frames must
+// not rebuild: only adds and frames where something expired may.
+static void BenchModifierStack() {
+    const int effectCount = 48;
+    const int frames = 120000;
+    const float delta = 1.f / 120.f;
+    auto makeModifier = [](int key) {
+        Modifier modifier;
+        modifier.speedMultiplier = 1.f + 0.002f * static_cast<float>(key % 5);
+        modifier.fireRateMultiplier = 1.f + 0.003f * static_cast<float>(key % 7);
+        modifier.spreadLevel = key % 3;
+        modifier.rocketLauncher = key == 7;
+        return modifier;
+    };
+
+    struct Timed {
+        int key;
+        float remaining;
+        Modifier modifier;
+    };
+    std::vector<Timed> timed;
+    timed.reserve(effectCount);
+    ModifierStack stack;
+    stack.Reserve(effectCount);
+    RngStream rng(31, 0);
+    for (int k = 0; k < effectCount; k++) {
+        float duration = 1.f + rng.Unit() * 30.f;
+        stack.Add(k, makeModifier(k), duration);
+        timed.push_back({k, duration, makeModifier(k)});
+    }
+
+    RngStream schedule(32, 0);
+    float sink = 0.f;
+    size_t adds = 0;
+    size_t expiryFrames = 0;
+    uint64_t rebuildsBefore = stack.Rebuilds();
+    double t0 = NowMs();
+    for (int f = 0; f < frames; f++) {
+        if (f % 60 == 0) {
+            int key = schedule.Range(0, effectCount - 1);
+            stack.Add(key, makeModifier(key), 1.f + schedule.Unit() * 30.f);
+            adds++;
+        }
+        bool expired = false;
+        stack.Advance(delta, [&expired](const ModifierStack::Effect&) { expired = true; });
+        if (expired) expiryFrames++;
+        sink += stack.Stats().fireRateMultiplier;
+    }
+    double stackNs = (NowMs() - t0) * 1e6 / frames;
+    uint64_t rebuilds = stack.Rebuilds() - rebuildsBefore;
+
+    schedule = RngStream(32, 0);
+    t0 = NowMs();
+    for (int f = 0; f < frames; f++) {
+        if (f % 60 == 0) {
+            int key = schedule.Range(0, effectCount - 1);
+            float duration = 1.f + schedule.Unit() * 30.f;
+            bool found = false;
+            for (Timed& effect : timed) {
+                if (effect.key != key) continue;
+                effect.remaining = duration;
+                found = true;
+            }
+            if (!found) timed.push_back({key, duration, makeModifier(key)});
+        }
+        for (Timed& effect : timed) effect.remaining -= delta;
+        RemoveDead(timed, [](const Timed& effect) { return effect.remaining <= 0.f; });
+        PowerStats stats;
+        for (const Timed& effect : timed) {
+            stats.speedMultiplier *= effect.modifier.speedMultiplier;
+            stats.fireRateMultiplier *= effect.modifier.fireRateMultiplier;
+            stats.damageMultiplier *= effect.modifier.damageMultiplier;
+            stats.spreadLevel = std::max(stats.spreadLevel, effect.modifier.spreadLevel);
+            stats.rocketLauncher = stats.rocketLauncher || effect.modifier.rocketLauncher;
+        }
+        sink += stats.fireRateMultiplier;
+    }
+    double rebuildNs = (NowMs() - t0) * 1e6 / frames;
+
+    bool ok = rebuilds <= adds + expiryFrames;
+    if (!ok) g_failures++;
+    printf("power-up modifier stack (%d effects, %d frames, refresh every 60, mean fire rate x%.3f)\n", effectCount,
+           frames, sink / (2.f * frames));
+    printf("  sorted deadlines %.1f ns/frame  per-frame rebuild %.1f ns/frame  rebuilds %llu (%zu adds, %zu expiry "
+           "frames)  %s\n",
+           stackNs, rebuildNs, static_cast<unsigned long long>(rebuilds), adds, expiryFrames, ok ? "ok" : "FAIL");
+}
+
+// Several rocket blasts in one frame over a dense field. Candidate gathering is timed
+// as a full scan per blast against one grid build plus a radius query per blast.
+// For correctness the old scan-and-damage loop runs on a copy and the survivors are
+// compared with Step's; drops are disabled so both sides roll nothing.
+static void BenchExplosionQuery() {
+    const int counts[] = {1000, 10000, 50000};
+    const int blasts = 16;
+    printf("explosion area damage (%d blasts in one frame)\n", blasts);
+    float savedDropChance = enemyDropChance;
+    enemyDropChance = 0.f;
+    for (int count : counts) {
+        GameSim sim;
+        sim.SetWorldSize(2000.f, 2000.f);
+        sim.player.position = {1000.f, 1000.f};
+        for (int i = 0; i < count; i++) {
+            Vector2 pos = {RandomRange(0.f, 2000.f), RandomRange(0.f, 2000.f)};
+            if (Vector2Distance(pos, sim.player.position) < 80.f) pos.x += 160.f;
+            sim.enemies.Push(Enemy(pos, static_cast<EnemyType>(i % 3), 1 + i % 20, RandomRange(0.f, 2.f * PI)));
+        }
+        sim.enemiesRemaining = count;
+        for (int b = 0; b < blasts; b++) {
+            Vector2 at = {RandomRange(0.f, 2000.f), RandomRange(0.f, 2000.f)};
+            sim.explosions.push_back(Explosion{at, GameSim::rocketExplosionRadius, 0.35f, 0.f, 45, false});
+        }
+
+        std::vector<int> hits;
+        hits.reserve(static_cast<size_t>(count));
+        size_t scanned = 0;
+        double t0 = NowMs();
+        for (auto &explosion : sim.explosions) {
+            hits.clear();
+            for (size_t idx = 0; idx < sim.enemies.Size(); idx++) {
+                if (Vector2Distance(explosion.position, sim.enemies.Position(idx)) <=
+                    explosion.radius + sim.enemies.radius[idx]) hits.push_back(static_cast<int>(idx));
+            }
+            scanned += hits.size();
+        }
+        double scanMs = NowMs() - t0;
+
+        GameSim probe = sim;
+        size_t queried = 0;
+        t0 = NowMs();
+        probe.BuildEnemyGrid();
+        for (auto &explosion : probe.explosions) {
+            probe.QueryEnemiesInRadius(explosion.position, explosion.radius, hits);
+            queried += hits.size();
+        }
+        double queryMs = NowMs() - t0;
+
+        EnemyStore reference = sim.enemies;
+        for (auto &explosion : sim.explosions) {
+            for (size_t idx = 0; idx < reference.Size(); idx++) {
+                if (reference.dead[idx]) continue;
+                Vector2 enemyPos = reference.Position(idx);
+                if (Vector2Distance(explosion.position, enemyPos) <= explosion.radius + reference.radius[idx]) {
+                    Vector2 knockDir = Vector2Subtract(enemyPos, explosion.position);
+                    if (Vector2Length(knockDir) > 0.f) knockDir = Vector2Normalize(knockDir);
+                    reference.ApplyHit(idx, explosion.damage, knockDir, 90.f);
+                    if (reference.health[idx] <= 0) reference.dead[idx] = 1;
+                }
+            }
+        }
+        reference.RemoveDead();
+        sim.Step(InputFrame{}, 0.f);  // zero dt: nothing moves except by knockback
+
+        bool match = scanned == queried && reference.posX == sim.enemies.posX &&
+                     reference.posY == sim.enemies.posY && reference.health == sim.enemies.health;
+        if (!match) g_failures++;
+        printf("  %6d enemies: full scan %8.3f ms  grid build+query %7.3f ms  speedup %5.1fx  (%zu survivors)  %s\n",
+               count, scanMs, queryMs, scanMs / (queryMs > 0.0 ? queryMs : 1e-6), sim.enemies.Size(),
+               match ? "match" : "MISMATCH");
+    }
+    enemyDropChance = savedDropChance;
+}
+
+// Draw-list builder on a crowded frame, no GPU involved. Vertex counts are checked
+// against the per-shape tessellation (grunt 540, runner 15, tank 360, bullet 48,
+// explosion 324) and every batch must fit rlgl's smallest default buffer.
+static void BenchDrawList() {
+    const int enemyCount = 3000;
+    const int bulletCount = 1000;
+    const int explosionCount = 12;
+    const int frames = 100;
+    GameSim sim;
+    FillField(sim, enemyCount, bulletCount);
+    for (int i = 0; i < explosionCount; i++) {
+        sim.explosions.push_back(Explosion{{RandomRange(0.f, 1000.f), RandomRange(0.f, 1000.f)},
+                                           GameSim::rocketExplosionRadius, 0.35f, 0.1f, 70, true});
+    }
+    size_t expected = 0;
+    int immediateCalls = 0;
+    for (size_t i = 0; i < sim.enemies.Size(); i++) {
+        switch (static_cast<EnemyType>(sim.enemies.type[i])) {
+            case EnemyType::GRUNT: expected += 540; immediateCalls += 3; break;
+            case EnemyType::RUNNER: expected += 15; immediateCalls += 2; break;
+            case EnemyType::TANK: expected += 360; immediateCalls += 3; break;
+        }
+    }
+    expected += sim.bullets.Size() * 48 + sim.explosions.size() * 324;
+    immediateCalls += static_cast<int>(sim.bullets.Size() + sim.explosions.size() * 2);
+
+    DrawList list;
+    list.Reserve(expected);
+    double t0 = NowMs();
+    for (int f = 0; f < frames; f++) {
+        list.Clear();
+        list.AddEnemies(sim.enemies);
+        list.AddBullets(sim.bullets);
+        list.AddExplosions(sim.explosions);
+    }
+    double buildMs = (NowMs() - t0) / frames;
+
+    bool batchesFit = true;
+    size_t covered = 0;
+    for (const DrawBatch& batch : list.Batches()) {
+        if (batch.count > DrawList::maxBatchVertices || batch.first != static_cast<int>(covered)) batchesFit = false;
+        covered += static_cast<size_t>(batch.count);
+    }
+    bool ok = batchesFit && covered == list.VertexCount() && list.VertexCount() == expected;
+    if (!ok) g_failures++;
+    printf("draw list (%d enemies, %d bullets, %d explosions)\n", enemyCount, bulletCount, explosionCount);
+    printf("  %zu vertices (expected %zu)  %zu batches vs %d immediate draw calls  build %.3f ms  %s\n",
+           list.VertexCount(), expected, list.BatchCount(), immediateCalls, buildMs, ok ? "ok" : "MISMATCH");
+}
+
+// The same 10 simulated seconds rendered at 30 Hz and 144 Hz. With the fixed-step
+// clock both runs take identical 120 Hz steps and must end in the same state; feeding
+// raw frame times (the old loop) is shown for contrast.
+static void BenchFixedTimestep() {
+    const float renderRates[] = {30.f, 144.f};
+    const int simSteps = 1200;  // 10 s at 120 Hz
+    uint64_t fixedHash[2] = {0, 0};
+    uint64_t rawHash[2] = {0, 0};
+    InputFrame input;
+    input.aim = {900.f, 200.f};
+    input.move = {-0.3f, 0.2f};
+    input.fire = true;
+    printf("fixed timestep (same 10 s at 30 Hz and 144 Hz rendering)\n");
+    for (int r = 0; r < 2; r++) {
+        GameSim sim;
+        sim.StartRun();
+        FixedTimestep clock(120.f, 8);
+        int done = 0;
+        while (done < simSteps) {
+            int steps = clock.Advance(1.f / renderRates[r]);
+            for (int s = 0; s < steps && done < simSteps; s++, done++) sim.Step(input, clock.StepSeconds());
+        }
+        fixedHash[r] = sim.StateChecksum();
+
+        GameSim raw;
+        raw.StartRun();
+        int frames = static_cast<int>(10.f * renderRates[r]);
+        for (int f = 0; f < frames; f++) raw.Step(input, 1.f / renderRates[r]);
+        rawHash[r] = raw.StateChecksum();
+    }
+    if (fixedHash[0] != fixedHash[1]) g_failures++;
+    printf("  fixed step: %016llx vs %016llx  %s\n", (unsigned long long)fixedHash[0],
+           (unsigned long long)fixedHash[1], fixedHash[0] == fixedHash[1] ? "identical" : "MISMATCH");
+    printf("  raw frame time: %016llx vs %016llx  %s\n", (unsigned long long)rawHash[0],
+           (unsigned long long)rawHash[1], rawHash[0] == rawHash[1] ? "identical" : "diverged (expected)");
+}
+
+// Game RNG: reproducibility from a seed, random access into a stream, and
+// independence (drawing from one subsystem never shifts another).
+static void BenchRng() {
+    const int draws = 10000000;
+    RngStream stream(20240101, static_cast<uint64_t>(RngStreamId::DROPS));
+    uint64_t sum = 0;
+    double t0 = NowMs();
+    for (int i = 0; i < draws; i++) sum += static_cast<uint64_t>(stream.Range(0, 999));
+    double ms = NowMs() - t0;
+    bool randomAccess = stream.At(draws - 1) == RngStream(20240101, static_cast<uint64_t>(RngStreamId::DROPS)).At(draws - 1);
+
+    GameRng a(7), b(7);
+    for (int i = 0; i < 1000; i++) b.drops.NextU64();
+    bool independent = true;
+    for (int i = 0; i < 1000; i++) independent &= a.waveSpawn.NextU64() == b.waveSpawn.NextU64();
+
+    GameSim first, second;
+    rngSeed = 12345;
+    first.StartRun();
+    second.StartRun();
+    InputFrame input;
+    input.aim = {100.f, 100.f};
+    input.fire = true;
+    for (int f = 0; f < 2400; f++) {
+        first.Step(input, 1.f / 120.f);
+        second.Step(input, 1.f / 120.f);
+    }
+    bool reproducible = first.StateChecksum() == second.StateChecksum();
+    rngSeed = 0;
+    if (!randomAccess || !independent || !reproducible) g_failures++;
+
+    printf("game rng (SplitMix counter streams)\n");
+    printf("  %.2f ns/draw (mean %.1f)  random access %s  streams %s  same seed %s\n",
+           ms * 1e6 / draws, static_cast<double>(sum) / draws, randomAccess ? "ok" : "MISMATCH",
+           independent ? "independent" : "COUPLED", reproducible ? "reproduces" : "MISMATCH");
+}
+
+// One frame of a scripted player: 60 Hz frame times with jitter, occasional key changes,
+// aiming at the nearest enemy and backing away from it.
+static void ScriptFrame(const GameSim& sim, RngStream& script, int f, RecordedFrame& frame) {
+    frame.delta = 1.f / 60.f + static_cast<float>(script.Range(-400, 400)) * 1e-6f;
+    if (f % 90 == 0) {
+        frame.keyX = static_cast<int8_t>(script.Range(-1, 1));
+        frame.keyY = static_cast<int8_t>(script.Range(-1, 1));
+    }
+    frame.fire = (f % 240) < 220;
+    Vector2 aim = {sim.worldWidth * 0.5f, 0.f};
+    float best = 1e30f;
+    for (size_t i = 0; i < sim.enemies.Size(); i++) {
+        float d = Vector2Distance(sim.enemies.Position(i), sim.player.position);
+        if (d < best) {
+            best = d;
+            aim = sim.enemies.Position(i);
+        }
+    }
+    frame.aim = {std::floor(aim.x), std::floor(aim.y)};  // mouse positions are whole pixels
+    // Back away from the closest enemy, leaning toward the centre near the walls.
+    Vector2 away = Vector2Normalize(Vector2Subtract(sim.player.position, aim));
+    Vector2 centre = Vector2Scale(Vector2Subtract({sim.worldWidth * 0.5f, sim.worldHeight * 0.5f},
+                                                  sim.player.position), 0.004f);
+    frame.stick = best < 260.f ? Vector2Add(away, centre) : Vector2{0.f, 0.f};
+}
+
+// A scripted 30-minute session (60 Hz frame times with jitter, strafing, aiming at the
+// nearest enemy, random upgrades) is recorded with per-frame checksums, then the log is
+// decoded and replayed uncapped; every checksum must match.
+static void BenchReplay() {
+    const int maxFrames = 30 * 60 * 60;
+    GameSim sim;
+    sim.StartRun();
+    FixedTimestep clock(120.f, 8);
+    InputRecorder recorder;
+    recorder.Begin(MakeReplayHeader(sim, clock));
+    RngStream script(42, 0);
+    std::vector<uint64_t> recorded;
+    recorded.reserve(maxFrames);
+    RecordedFrame frame;
+    double t0 = NowMs();
+    for (int f = 0; f < maxFrames; f++) {
+        ScriptFrame(sim, script, f, frame);
+        recorder.RecordFrame(frame);
+        SimEvents events = RunSimFrame(sim, clock, frame.ToInput(), frame.delta);
+        recorded.push_back(sim.StateChecksum());
+        if (events.gameOver) break;
+        if (events.waveCleared) {
+            int option = script.Range(0, 2);
+            sim.ApplyUpgrade(option);
+            recorder.RecordUpgrade(option);
+            clock.Reset();
+        }
+    }
+    double recordMs = NowMs() - t0;
+
+    InputPlayback playback;
+    bool opened = playback.Open(recorder.Bytes());
+    ReplayStats stats;
+    size_t mismatches = 0;
+    t0 = NowMs();
+    RunReplay(playback, stats, [&](size_t index, const GameSim& replayed) {
+        if (index >= recorded.size() || replayed.StateChecksum() != recorded[index]) mismatches++;
+    });
+    double replayMs = NowMs() - t0;
+
+    bool ok = opened && mismatches == 0 && stats.frames == recorded.size();
+    if (!ok) g_failures++;
+    printf("input replay (%zu frames, %.1f min simulated, reached wave %d%s)\n", recorded.size(),
+           stats.simulatedSeconds / 60.0, sim.currentWave, stats.gameOver ? ", game over" : "");
+    printf("  log %zu bytes (%.2f bytes/frame)  record+play %.0f ms  replay %.0f ms  checksums %s\n",
+           recorder.Bytes().size(), static_cast<double>(recorder.Bytes().size()) / recorded.size(),
+           recordMs, replayMs, ok ? "identical" : "MISMATCH");
+}
+
+// Snapshot save/restore on a live horde fight of about 1,000 entities. The blob must
+// restore to the same counts with positions within half a quantization step, re-save to
+// the same bytes, and repeated saves and restores must stay off the heap. A truncated blob
+// and blobs with a corrupt world size or header value must be rejected without changing
+// the sim, and a world too large to encode must refuse to save.
+static void BenchSnapshot() {
+    const int steps = 240;
+    const int repeats = 2000;
+    const float delta = 1.f / 120.f;
+    const double budgetUs = 50.0;
+    GameSim sim;
+    sim.horde.enabled = true;
+    sim.horde.aliveCap = 1000;
+    sim.StartRun(0x5A7Eull);
+    sim.currentWave = 4;
+    sim.SpawnWave(sim.currentWave);
+    sim.GrantPowerUp(PowerUpType::RAPID_FIRE, 30.f);
+    sim.GrantPowerUp(PowerUpType::SPREAD_SHOT, 20.f);
+    sim.GrantPowerUp(PowerUpType::DAMAGE_BOOST, 25.f);
+    InputFrame input;
+    input.fire = true;
+    for (int f = 0; f < steps; f++) {
+        sim.player.health = sim.player.maxHealth;
+        float t = static_cast<float>(f) * 0.05f;
+        input.aim = {sim.player.position.x + cosf(t) * 200.f, sim.player.position.y + sinf(t) * 200.f};
+        sim.Step(input, delta);
+    }
+    size_t entities = sim.enemies.Size() + sim.bullets.Size() + sim.powerUps.size() + sim.explosions.size();
+
+    // The first save and restore size the buffer and the target sim; only the repeats are timed.
+    std::vector<uint8_t> blob;
+    sim.SaveSnapshot(blob);
+    GameSim restored;
+    bool loaded = restored.RestoreSnapshot(blob.data(), blob.size());
+    size_t allocationsBefore = AllocationCount();
+    double t0 = NowMs();
+    for (int r = 0; r < repeats; r++) sim.SaveSnapshot(blob);
+    double saveUs = (NowMs() - t0) * 1e3 / repeats;
+
+    t0 = NowMs();
+    for (int r = 0; r < repeats; r++) loaded &= restored.RestoreSnapshot(blob.data(), blob.size());
+    double restoreUs = (NowMs() - t0) * 1e3 / repeats;
+    size_t allocations = AllocationCount() - allocationsBefore;
+
+    bool same = loaded && restored.enemies.Size() == sim.enemies.Size() && restored.bullets.Size() == sim.bullets.Size() &&
+                restored.powerUps.size() == sim.powerUps.size() && restored.explosions.size() == sim.explosions.size() &&
+                restored.powerUpEffects.Size() == sim.powerUpEffects.Size() && restored.currentWave == sim.currentWave &&
+                restored.enemiesRemaining == sim.enemiesRemaining && restored.pendingSpawns == sim.pendingSpawns;
+    float worstError = 0.f;
+    for (size_t i = 0; same && i < sim.enemies.Size(); i++) {
+        worstError = std::max(worstError, Vector2Distance(sim.enemies.Position(i), restored.enemies.Position(i)));
+        same &= restored.enemies.health[i] == sim.enemies.health[i] && restored.enemies.type[i] == sim.enemies.type[i];
+    }
+    for (size_t i = 0; same && i < sim.bullets.Size(); i++) {
+        worstError = std::max(worstError, Vector2Distance(sim.bullets[i].position, restored.bullets[i].position));
+    }
+    std::vector<uint8_t> resaved;
+    restored.SaveSnapshot(resaved);
+    bool stable = resaved == blob;
+    bool precise = worstError <= 0.5f * std::sqrt(2.f) / snapshotPositionScale;
+
+    uint64_t before = restored.StateChecksum();
+    bool rejected = !restored.RestoreSnapshot(blob.data(), blob.size() - 1) &&
+                    restored.StateChecksum() == before;
+    // Corrupt world sizes in an otherwise valid blob: the width sits right after magic and version.
+    const float badSizes[] = {NAN, -1.f, 0.f, 1e9f, snapshotMaxCoord * 2.f};
+    std::vector<uint8_t> corrupt;
+    for (float badSize : badSizes) {
+        corrupt = blob;
+        memcpy(&corrupt[6], &badSize, sizeof(float));
+        rejected &= !restored.RestoreSnapshot(corrupt.data(), corrupt.size());
+    }
+    // Corrupt run-wide values in blobs of the right length, saved from the live sim with
+    // one field broken at a time; the last pair once reserved gigabytes for the roster.
+    const Player savedPlayer = sim.player;
+    const HordeSettings savedHorde = sim.horde;
+    const int savedWave = sim.currentWave;
+    const int savedPending = sim.pendingSpawns;
+    for (int c = 0; c < 8; c++) {
+        switch (c) {
+            case 0: sim.player.maxHealth = 0; break;
+            case 1: sim.player.health = sim.player.maxHealth + 1; break;
+            case 2: sim.player.health = -1; break;
+            case 3: sim.player.position.x = NAN; break;
+            case 4: sim.currentWave = 0; break;
+            case 5: sim.pendingSpawns = -1; break;
+            case 6: sim.horde.spawnPerStep = 0; break;
+            default: sim.pendingSpawns = INT_MAX; sim.horde.aliveCap = INT_MAX; break;
+        }
+        sim.SaveSnapshot(corrupt);
+        rejected &= corrupt.size() == blob.size() && !restored.RestoreSnapshot(corrupt.data(), corrupt.size());
+        sim.player = savedPlayer;
+        sim.horde = savedHorde;
+        sim.currentWave = savedWave;
+        sim.pendingSpawns = savedPending;
+    }
+    rejected &= restored.StateChecksum() == before && restored.worldWidth == sim.worldWidth;
+
+    // A world past the q16 range (a 5K-wide window) must refuse to save rather than write
+    // a blob no restore accepts.
+    GameSim wide;
+    wide.SetWorldSize(5120.f, 1440.f);
+    corrupt.clear();
+    bool refused = !wide.SaveSnapshot(corrupt) && corrupt.empty();
+
+    // The raw figure is what the same entities occupy in the sim's own storage.
+    size_t rawBytes = sim.enemies.Size() * (12 * sizeof(float) + sizeof(int) + 2) + sim.bullets.Size() * sizeof(Bullet) +
+                      sim.powerUps.size() * sizeof(PowerUp) + sim.explosions.size() * sizeof(Explosion);
+    bool ok = same && stable && precise && rejected && refused && allocations == 0;
+    if (!ok) g_failures++;
+    printf("game-state snapshot (%zu entities: %zu enemies, %zu projectiles, %zu pickups, %zu explosions)\n", entities,
+           sim.enemies.Size(), sim.bullets.Size(), sim.powerUps.size(), sim.explosions.size());
+    printf("  %zu bytes (%.1f B/entity, raw state %zu B)  save %.1f us  restore %.1f us  %s %.0f us budget\n",
+           blob.size(), static_cast<double>(blob.size()) / static_cast<double>(entities), rawBytes, saveUs, restoreUs,
+           saveUs + restoreUs <= budgetUs ? "within" : "OVER", budgetUs);
+    printf("  worst position error %.3f px  re-save %s  truncated and corrupt blobs %s  oversized world %s\n",
+           worstError, stable ? "identical" : "DIFFERS", rejected ? "rejected" : "ACCEPTED",
+           refused ? "refused" : "SAVED");
+    printf("  heap allocations %zu  %s\n", allocations, ok ? "ok" : "FAIL");
+}
+
+// =====================================================
+// Scenario suite
+// Scripted whole-Step workloads for comparing builds. Each scenario sets up a sim,
+// drives it for a fixed number of 120 Hz steps and times only GameSim::Step; the
+// per-frame driver (aiming, refilling the field, keeping the player alive) runs
+// outside the timed region. `bench --json [file]` prints the results as JSON.
+// =====================================================
+
+struct Scenario {
+    const char* name;
+    const char* description;
+    int warmupFrames;
+    int frames;
+    void (*setup)(GameSim& sim, RngStream& rng);
+    void (*drive)(GameSim& sim, RngStream& rng, int frame, InputFrame& input);
+};
+
+struct ScenarioResult {
+    const char* name;
+    const char* description;
+    int frames;
+    double meanNs;
+    double p50Ns;
+    double p99Ns;
+    double maxNs;
+    double allocationsPerFrame;
+    double entitiesPerFrame;   // enemies + projectiles alive when the step starts
+    double entitiesPerSecond;  // entity updates per second of Step time
+    uint64_t checksum;         // end state, so two builds can confirm they simulated the same thing
+    double phaseNs[FrameProfiler::phaseCount];  // mean per frame, FRAME_PROFILER builds only
+};
+
+static const float scenarioStep = 1.f / 120.f;
+
+static void KeepPlayerAlive(GameSim& sim) {
+    sim.player.health = sim.player.maxHealth;
+    sim.gameOver = false;
+}
+
+static void AimAtNearestEnemy(const GameSim& sim, InputFrame& input) {
+    input.aim = {sim.worldWidth * 0.5f, 0.f};
+    float best = 1e30f;
+    for (size_t i = 0; i < sim.enemies.Size(); i++) {
+        float d = Vector2DistanceSqr(sim.enemies.Position(i), sim.player.position);
+        if (d < best) {
+            best = d;
+            input.aim = sim.enemies.Position(i);
+        }
+    }
+}
+
+// Strafes in a slow circle so contacts, pickups and wall clamps all get exercised.
+static void Strafe(int frame, InputFrame& input) {
+    float t = static_cast<float>(frame) * scenarioStep;
+    input.move = {cosf(t * 0.8f), sinf(t * 0.8f)};
+}
+
+static void StartWave(GameSim& sim, int wave) {
+    sim.currentWave = wave;
+    sim.SpawnWave(wave);
+}
+
+// Restarts the same wave whenever it is cleared, so the mix stays constant.
+static void DriveWave(GameSim& sim, int frame, InputFrame& input) {
+    KeepPlayerAlive(sim);
+    if (sim.enemies.Size() == 0) StartWave(sim, sim.currentWave);
+    sim.enemiesRemaining = static_cast<int>(sim.enemies.Size()) + 1;
+    Strafe(frame, input);
+    AimAtNearestEnemy(sim, input);
+    input.fire = true;
+}
+
+// Tops the field up to `count` enemies of the current wave's stats at random edges.
+static void RefillEnemies(GameSim& sim, RngStream& rng, size_t count) {
+    while (sim.enemies.Size() < count) {
+        Vector2 spawn = {rng.Unit() * sim.worldWidth, rng.Unit() * sim.worldHeight};
+        EnemyType type = static_cast<EnemyType>(rng.Range(0, 2));
+        sim.enemies.Push(Enemy(spawn, type, sim.enemyStats, rng.Unit() * 2.f * PI));
+    }
+    sim.enemiesRemaining = static_cast<int>(sim.enemies.Size()) + 1;
+}
+
+static void GrantPowerUp(GameSim& sim, PowerUpType type) {
+    sim.GrantPowerUp(type, 1e9f);
+}
+
+static const Scenario scenarios[] = {
+    {"wave_1", "wave 1 mix (grunts only), restarted on clear", 240, 4800,
+     [](GameSim& sim, RngStream&) { StartWave(sim, 1); },
+     [](GameSim& sim, RngStream&, int frame, InputFrame& input) { DriveWave(sim, frame, input); }},
+    {"wave_40", "wave 40 mix (grunt/runner/tank at wave 40 stats), restarted on clear", 240, 4800,
+     [](GameSim& sim, RngStream&) { StartWave(sim, 40); },
+     [](GameSim& sim, RngStream&, int frame, InputFrame& input) { DriveWave(sim, frame, input); }},
+    {"spread_rapid_fire", "sustained spread + rapid fire at the cooldown floor into 150 wave 10 enemies", 240, 4800,
+     [](GameSim& sim, RngStream& rng) {
+         StartWave(sim, 10);
+         sim.permanentFireRateMultiplier = 4.f;
+         sim.powerUpSpawnTimer = 1e9f;
+         GrantPowerUp(sim, PowerUpType::RAPID_FIRE);
+         GrantPowerUp(sim, PowerUpType::SPREAD_SHOT);
+         RefillEnemies(sim, rng, 150);
+     },
+     [](GameSim& sim, RngStream& rng, int frame, InputFrame& input) {
+         KeepPlayerAlive(sim);
+         RefillEnemies(sim, rng, 150);
+         float angle = static_cast<float>(frame) * 0.03f;
+         input.aim = {sim.player.position.x + cosf(angle) * 300.f, sim.player.position.y + sinf(angle) * 300.f};
+         input.fire = true;
+     }},
+    {"rocket_storm", "rapid rockets plus 32 scattered blasts per second over 2000 wave 20 enemies", 240, 2400,
+     [](GameSim& sim, RngStream& rng) {
+         StartWave(sim, 20);
+         sim.permanentFireRateMultiplier = 4.f;
+         sim.powerUpSpawnTimer = 1e9f;
+         GrantPowerUp(sim, PowerUpType::ROCKET_LAUNCHER);
+         GrantPowerUp(sim, PowerUpType::RAPID_FIRE);
+         GrantPowerUp(sim, PowerUpType::SPREAD_SHOT);
+         RefillEnemies(sim, rng, 2000);
+     },
+     [](GameSim& sim, RngStream& rng, int frame, InputFrame& input) {
+         KeepPlayerAlive(sim);
+         RefillEnemies(sim, rng, 2000);
+         // Extra rockets launched from random points so blasts land all over the field.
+         if (frame % 15 == 0) {
+             for (int i = 0; i < 4; i++) {
+                 Vector2 at = {rng.Unit() * sim.worldWidth, rng.Unit() * sim.worldHeight};
+                 float angle = (rng.Unit() * 2.f - 1.f) * PI;
+                 Vector2 vel = {cosf(angle) * GameSim::baseRocketSpeed, sinf(angle) * GameSim::baseRocketSpeed};
+                 sim.bullets.Push(Bullet(at, vel, GameSim::baseRocketDamage, ORANGE, ProjectileType::ROCKET,
+                                         GameSim::rocketExplosionRadius));
+             }
+         }
+         AimAtNearestEnemy(sim, input);
+         input.fire = true;
+     }},
+    {"horde_stream", "horde wave 60 (18500 enemies) streamed in 256 per step under the 20k alive cap", 60, 1200,
+     [](GameSim& sim, RngStream&) {
+         sim.horde.enabled = true;
+         StartWave(sim, 60);
+     },
+     [](GameSim& sim, RngStream&, int frame, InputFrame& input) {
+         KeepPlayerAlive(sim);
+         if (sim.enemiesRemaining == 0) StartWave(sim, sim.currentWave);
+         Strafe(frame, input);
+         AimAtNearestEnemy(sim, input);
+         input.fire = true;
+     }},
+    {"bullet_saturation_10k", "10k projectiles in flight over 500 wave 5 enemies, topped up every frame", 60, 1200,
+     [](GameSim& sim, RngStream& rng) {
+         StartWave(sim, 5);
+         sim.powerUpSpawnTimer = 1e9f;
+         sim.bullets.SetCapacity(10000);
+         RefillEnemies(sim, rng, 500);
+     },
+     [](GameSim& sim, RngStream& rng, int, InputFrame& input) {
+         KeepPlayerAlive(sim);
+         RefillEnemies(sim, rng, 500);
+         float speed = GameSim::baseBulletSpeed;
+         while (sim.bullets.Size() < sim.bullets.Capacity()) {
+             Vector2 start = {rng.Unit() * sim.worldWidth, rng.Unit() * sim.worldHeight};
+             float angle = (rng.Unit() * 2.f - 1.f) * PI;
+             sim.bullets.Push(Bullet(start, Vector2{cosf(angle) * speed, sinf(angle) * speed},
+                                     GameSim::baseBulletDamage, YELLOW, ProjectileType::BULLET));
+         }
+         input.fire = false;
+     }},
+};
+
+static double Percentile(std::vector<double>& sorted, double fraction) {
+    if (sorted.empty()) return 0.0;
+    size_t index = static_cast<size_t>(fraction * static_cast<double>(sorted.size() - 1) + 0.5);
+    return sorted[index];
+}
+
+static ScenarioResult RunScenario(const Scenario& scenario) {
+    using clock = std::chrono::steady_clock;
+    GameSim sim;
+    sim.StartRun(0x5CE4A210ull);
+    RngStream rng(0x5CE4A210ull, 100);
+    scenario.setup(sim, rng);
+
+    InputFrame input;
+    for (int f = 0; f < scenario.warmupFrames; f++) {
+        scenario.drive(sim, rng, f, input);
+        sim.Step(input, scenarioStep);
+    }
+
+    std::vector<double> frameNs;
+    frameNs.reserve(static_cast<size_t>(scenario.frames));
+    size_t allocations = 0;
+    double entities = 0.0;
+    double phaseNs[FrameProfiler::phaseCount] = {};
+    FrameProfiler& profiler = FrameProfiler::Instance();
+    profiler.NextFrame();
+    for (int f = 0; f < scenario.frames; f++) {
+        scenario.drive(sim, rng, scenario.warmupFrames + f, input);
+        entities += static_cast<double>(sim.enemies.Size() + sim.bullets.Size());
+        size_t allocsBefore = AllocationCount();
+        clock::time_point t0 = clock::now();
+        sim.Step(input, scenarioStep);
+        clock::time_point t1 = clock::now();
+        allocations += AllocationCount() - allocsBefore;
+        frameNs.push_back(std::chrono::duration<double, std::nano>(t1 - t0).count());
+        for (int p = 0; p < FrameProfiler::phaseCount; p++) {
+            phaseNs[p] += static_cast<double>(profiler.CurrentFrameNs(static_cast<ProfilePhase>(p)));
+        }
+        profiler.NextFrame();
+    }
+
+    ScenarioResult result = {};
+    result.name = scenario.name;
+    result.description = scenario.description;
+    result.frames = scenario.frames;
+    double totalNs = 0.0;
+    for (double ns : frameNs) totalNs += ns;
+    std::sort(frameNs.begin(), frameNs.end());
+    result.meanNs = totalNs / scenario.frames;
+    result.p50Ns = Percentile(frameNs, 0.50);
+    result.p99Ns = Percentile(frameNs, 0.99);
+    result.maxNs = frameNs.back();
+    result.allocationsPerFrame = static_cast<double>(allocations) / scenario.frames;
+    result.entitiesPerFrame = entities / scenario.frames;
+    result.entitiesPerSecond = totalNs > 0.0 ? entities / (totalNs * 1e-9) : 0.0;
+    result.checksum = sim.StateChecksum();
+    for (int p = 0; p < FrameProfiler::phaseCount; p++) result.phaseNs[p] = phaseNs[p] / scenario.frames;
+    return result;
+}
+
+static void WriteScenarioJson(FILE* out, const std::vector<ScenarioResult>& results) {
+#if defined(ENEMY_KERNEL_AVX2)
+    const char* kernel = "avx2";
+#elif defined(ENEMY_KERNEL_SSE2)
+    const char* kernel = "sse2";
+#else
+    const char* kernel = "scalar";
+#endif
+    fprintf(out, "{\n  \"step_hz\": %.0f,\n  \"enemy_kernel\": \"%s\",\n  \"scenarios\": [\n",
+            1.0 / scenarioStep, kernel);
+    for (size_t i = 0; i < results.size(); i++) {
+        const ScenarioResult& r = results[i];
+        fprintf(out,
+                "    {\"name\": \"%s\", \"description\": \"%s\", \"frames\": %d, "
+                "\"ns_per_frame\": %.0f, \"p50_ns\": %.0f, \"p99_ns\": %.0f, \"max_ns\": %.0f, "
+                "\"allocations_per_frame\": %.3f, \"entities_per_frame\": %.1f, \"entities_per_second\": %.0f, "
+                "\"checksum\": \"%016llx\"",
+                r.name, r.description, r.frames, r.meanNs, r.p50Ns, r.p99Ns, r.maxNs, r.allocationsPerFrame,
+                r.entitiesPerFrame, r.entitiesPerSecond, static_cast<unsigned long long>(r.checksum));
+        if (FrameProfiler::enabled) {
+            fprintf(out, ", \"phase_ns\": {");
+            // Only the simulation phases run here, SIM_STEP through CLEANUP.
+            for (int p = 0; p <= static_cast<int>(ProfilePhase::CLEANUP); p++) {
+                fprintf(out, "%s\"%s\": %.0f", p ? ", " : "", GetProfilePhaseName(static_cast<ProfilePhase>(p)),
+                        r.phaseNs[p]);
+            }
+            fprintf(out, "}");
+        }
+        fprintf(out, "}%s\n", i + 1 < results.size() ? "," : "");
+    }
+    fprintf(out, "  ]\n}\n");
+}
+
+static std::vector<ScenarioResult> RunScenarios() {
+    std::vector<ScenarioResult> results;
+    for (const Scenario& scenario : scenarios) results.push_back(RunScenario(scenario));
+    return results;
+}
+
+static void PrintScenarios(const std::vector<ScenarioResult>& results) {
+    printf("scenario suite (%.0f Hz steps, Step time only)\n", 1.0 / scenarioStep);
+    for (const ScenarioResult& r : results) {
+        printf("  %-22s %9.0f ns/frame  p50 %9.0f  p99 %9.0f  %6.2f allocs/frame  %7.0f entities  %6.1f M entities/s\n",
+               r.name, r.meanNs, r.p50Ns, r.p99Ns, r.allocationsPerFrame, r.entitiesPerFrame,
+               r.entitiesPerSecond * 1e-6);
+        if (!FrameProfiler::enabled) continue;
+        for (int p = static_cast<int>(ProfilePhase::ENEMY_SPAWN); p <= static_cast<int>(ProfilePhase::CLEANUP); p++) {
+            printf("      %-18s %9.0f ns\n", GetProfilePhaseName(static_cast<ProfilePhase>(p)), r.phaseNs[p]);
+        }
+    }
+}
+
+// Scripted PLAYING frames (input recording, fixed-step sim on the job pool, draw-list build)
+// across several waves and restarts. After a 120-frame warm-up per wave, any heap allocation
+// inside a frame fails the run.
+static void BenchSteadyState() {
+    const int frames = 20000;
+    JobSystem jobs(4);
+    GameSim sim;
+    sim.jobs = &jobs;
+    sim.StartRun(0x57EADull);
+    FixedTimestep clock(120.f, 8);
+    InputRecorder recorder;
+    recorder.Begin(MakeReplayHeader(sim, clock));
+    DrawList drawList;
+    drawList.Reserve(64 * 1024);
+    SteadyStateCheck check(120);
+    FrameArena frameArena(16 * 1024);
+    RngStream script(7, 0);
+    RecordedFrame frame;
+    int waves = 0;
+    int runs = 1;
+    for (int f = 0; f < frames; f++) {
+        ScriptFrame(sim, script, f, frame);
+        check.BeginFrame();
+        frameArena.Reset();
+        recorder.RecordFrame(frame);
+        SimEvents events = RunSimFrame(sim, clock, frame.ToInput(), frame.delta);
+        drawList.Clear();
+        drawList.AddEnemies(sim.enemies, clock.Alpha());
+        drawList.AddBullets(sim.bullets, clock.Alpha());
+        drawList.AddExplosions(sim.explosions);
+        // Stand-in for the per-frame debug strings the game formats into its frame arena.
+        frameArena.Format("enemies %zu  bullets %zu", sim.enemies.Size(), sim.bullets.Size());
+        frameArena.Format("wave %d  remaining %d", sim.currentWave, sim.enemiesRemaining);
+        check.EndFrame();
+
+        // Leaving PLAYING (upgrade screen, game over) is where storage may legitimately grow.
+        if (events.gameOver) {
+            sim.StartRun(0x57EADull + static_cast<uint64_t>(runs++));
+            clock.Reset();
+            recorder.Begin(MakeReplayHeader(sim, clock));
+            check.Reset();
+        } else if (events.waveCleared) {
+            sim.ApplyUpgrade(script.Range(0, 2));
+            clock.Reset();
+            waves++;
+            check.Reset();
+        }
+    }
+    bool ok = check.Violations() == 0;
+    if (!ok) g_failures++;
+    printf("steady-state allocations (%d frames, %d waves cleared, %d runs, %zu frames checked)\n", frames, waves,
+           runs, check.FramesChecked());
+    printf("  %zu frames allocated (%zu allocations)  %s\n", check.Violations(), check.ViolatingAllocations(),
+           ok ? "ok" : "FAIL");
+    printf("  sim scratch high-water %zu B (capacity %zu B, %zu overflows)  frame arena high-water %zu B\n",
+           sim.Scratch().HighWater(), sim.Scratch().Capacity(), sim.Scratch().Overflows(), frameArena.HighWater());
+}
+
+int main(int argc, char** argv) {
+    // `bench --json [file]` runs only the scenario suite and emits machine-readable results.
+    if (argc >= 2 && strcmp(argv[1], "--json") == 0) {
+        std::vector<ScenarioResult> results = RunScenarios();
+        FILE* out = argc >= 3 ? fopen(argv[2], "w") : stdout;
+        if (!out) {
+            fprintf(stderr, "cannot open %s\n", argv[2]);
+            return 1;
+        }
+        WriteScenarioJson(out, results);
+        if (out != stdout) fclose(out);
+        return 0;
+    }
+
+    srand(1234);
+    BenchFastMath();
+    BenchEnemyKernel();
+    BenchJobSystem();
+    BenchParallelCollision();
+    BenchCollisionScaling();
+    BenchSweptCollision();
+    BenchMassDeath();
+    BenchBulletPool();
+    BenchModifierStack();
+    BenchArchetypeSpawn();
+    BenchHordeSpawn();
+    BenchFlowField();
+    BenchCrowdSeparation();
+    BenchExplosionQuery();
+    BenchDrawList();
+    BenchFixedTimestep();
+    BenchRng();
+    BenchReplay();
+    BenchSnapshot();
+    BenchSteadyState();
+    PrintScenarios(RunScenarios());
+    return g_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,222 @@
+#pragma once
+
+#include "raylib.h"
+#include "rlgl.h"
+#include "game_sim.h"
+#include <vector>
+#include <cmath>
+
+// =====================================================
+// Batched draw list for gameplay entities
+// Enemies, bullets and explosions are appended as plain triangles into one
+// vertex buffer, using unit circle tables built once, then handed to rlgl in
+// a few large batches. Building the list never touches the GPU, so vertex and
+// batch counts can be checked headless.
+// =====================================================
+
+struct DrawVertex {
+    float x, y;
+    Color color;
+};
+
+struct DrawBatch {
+    int first;
+    int count;
+};
+
+// Unit circle points for a fixed segment count; point[segments] repeats point[0].
+class CircleTemplate {
+public:
+    explicit CircleTemplate(int segments) : segments(segments) {
+        points.reserve(static_cast<size_t>(segments + 1));
+        for (int i = 0; i <= segments; i++) {
+            float angle = 2.f * PI * static_cast<float>(i % segments) / static_cast<float>(segments);
+            points.push_back({cosf(angle), sinf(angle)});
+        }
+    }
+
+    int Segments() const { return segments; }
+    const Vector2& operator[](int i) const { return points[i]; }
+
+    // Shared tables: 36 matches raylib's DrawCircleV, 24 the rings, 16 small projectiles.
+    static const CircleTemplate& Fine() { static const CircleTemplate t(36); return t; }
+    static const CircleTemplate& Ring() { static const CircleTemplate t(24); return t; }
+    static const CircleTemplate& Small() { static const CircleTemplate t(16); return t; }
+
+private:
+    int segments;
+    std::vector<Vector2> points;
+};
+
+class DrawList {
+public:
+    // Fits rlgl's smallest default batch (OpenGL ES2: 2048 quads = 8192 vertices).
+    static constexpr int maxBatchVertices = 8190;
+
+    void Clear() {
+        vertices.clear();
+        batches.clear();
+    }
+    void Reserve(size_t vertexCount) {
+        vertices.reserve(vertexCount);
+        batches.reserve(vertexCount / maxBatchVertices + 1);
+    }
+
+    void AddTriangle(Vector2 a, Vector2 b, Vector2 c, Color color);
+    void AddCircle(Vector2 center, float radius, Color color,
+                   const CircleTemplate& shape = CircleTemplate::Fine());
+    void AddRing(Vector2 center, float innerRadius, float outerRadius, Color color,
+                 const CircleTemplate& shape = CircleTemplate::Fine());
+    // One pixel outline, the batched stand-in for DrawCircleLines.
+    void AddCircleOutline(Vector2 center, float radius, Color color) {
+        AddRing(center, radius - 0.5f, radius + 0.5f, color);
+    }
+    // Square rotated so its first corner points along `facing` (unit length).
+    void AddSquare(Vector2 center, float radius, Vector2 facing, Color color);
+
+    // alpha blends from the previous step's positions (0) to the current ones (1).
+    void AddEnemies(const EnemyStore& enemies, float alpha = 1.f);
+    void AddBullets(const FixedPool<Bullet>& bullets, float alpha = 1.f);
+    void AddExplosions(const std::vector<Explosion>& explosions);
+
+    // Streams every batch to rlgl; needs a GL context.
+    void Submit() const;
+
+    size_t VertexCount() const { return vertices.size(); }
+    size_t TriangleCount() const { return vertices.size() / 3; }
+    size_t BatchCount() const { return batches.size(); }
+    const std::vector<DrawVertex>& Vertices() const { return vertices; }
+    const std::vector<DrawBatch>& Batches() const { return batches; }
+
+private:
+    std::vector<DrawVertex> vertices;
+    std::vector<DrawBatch> batches;
+
+    // Opens a new batch when the next primitive would not fit in the current one.
+    void Begin(int vertexCount) {
+        if (batches.empty() || batches.back().count + vertexCount > maxBatchVertices) {
+            batches.push_back({static_cast<int>(vertices.size()), 0});
+        }
+        batches.back().count += vertexCount;
+    }
+    void Emit(float x, float y, Color color) { vertices.push_back({x, y, color}); }
+};
+
+// Winding follows raylib's shape functions (center, next, current).
+inline void DrawList::AddTriangle(Vector2 a, Vector2 b, Vector2 c, Color color) {
+    Begin(3);
+    Emit(a.x, a.y, color);
+    Emit(b.x, b.y, color);
+    Emit(c.x, c.y, color);
+}
+
+inline void DrawList::AddCircle(Vector2 center, float radius, Color color, const CircleTemplate& shape) {
+    int segments = shape.Segments();
+    Begin(segments * 3);
+    for (int i = 0; i < segments; i++) {
+        Emit(center.x, center.y, color);
+        Emit(center.x + shape[i + 1].x * radius, center.y + shape[i + 1].y * radius, color);
+        Emit(center.x + shape[i].x * radius, center.y + shape[i].y * radius, color);
+    }
+}
+
+inline void DrawList::AddRing(Vector2 center, float innerRadius, float outerRadius, Color color,
+                              const CircleTemplate& shape) {
+    int segments = shape.Segments();
+    Begin(segments * 6);
+    for (int i = 0; i < segments; i++) {
+        float ix0 = center.x + shape[i].x * innerRadius, iy0 = center.y + shape[i].y * innerRadius;
+        float ix1 = center.x + shape[i + 1].x * innerRadius, iy1 = center.y + shape[i + 1].y * innerRadius;
+        float ox0 = center.x + shape[i].x * outerRadius, oy0 = center.y + shape[i].y * outerRadius;
+        float ox1 = center.x + shape[i + 1].x * outerRadius, oy1 = center.y + shape[i + 1].y * outerRadius;
+        Emit(ix0, iy0, color);
+        Emit(ox1, oy1, color);
+        Emit(ox0, oy0, color);
+        Emit(ix0, iy0, color);
+        Emit(ix1, iy1, color);
+        Emit(ox1, oy1, color);
+    }
+}
+
+inline void DrawList::AddSquare(Vector2 center, float radius, Vector2 facing, Color color) {
+    // Quarter turns of the facing vector are the corners; no trig needed.
+    Vector2 corners[5] = {
+        {facing.x, facing.y}, {-facing.y, facing.x}, {-facing.x, -facing.y}, {facing.y, -facing.x},
+        {facing.x, facing.y}
+    };
+    Begin(12);
+    for (int i = 0; i < 4; i++) {
+        Emit(center.x, center.y, color);
+        Emit(center.x + corners[i + 1].x * radius, center.y + corners[i + 1].y * radius, color);
+        Emit(center.x + corners[i].x * radius, center.y + corners[i].y * radius, color);
+    }
+}
+
+// Same shapes as Enemy::Draw, read straight from the SoA streams.
+inline void DrawList::AddEnemies(const EnemyStore& enemies, float alpha) {
+    static const float tailCos = cosf(0.6f);
+    static const float tailSin = sinf(0.6f);
+    const Color outline = Fade(BLACK, 0.5f);
+    for (size_t i = 0; i < enemies.Size(); i++) {
+        Vector2 position = enemies.InterpolatedPosition(i, alpha);
+        float radius = enemies.radius[i];
+        const EnemyArchetype& archetype = GetEnemyArchetype(enemies.type[i]);
+        Color flash = archetype.flashColor;
+        Color color = enemies.flashTimer[i] > 0.f ? flash : archetype.baseColor;
+        switch (archetype.shape) {
+            case EnemyShape::ROUND: {
+                AddCircle(position, radius, color);
+                AddCircleOutline(position, radius, outline);
+                AddCircleOutline(position, radius * 0.55f, Fade(flash, 0.4f));
+            } break;
+            case EnemyShape::DART: {
+                Vector2 facing = {enemies.facingX[i], enemies.facingY[i]};
+                if (facing.x == 0.f && facing.y == 0.f) facing = {1.f, 0.f};
+                AddSquare(position, radius * 1.2f, facing, color);
+                Vector2 head = {position.x + facing.x * radius * 1.2f, position.y + facing.y * radius * 1.2f};
+                Vector2 back = {-facing.x * radius * 1.6f, -facing.y * radius * 1.6f};
+                Vector2 tailLeft = {position.x + back.x * tailCos - back.y * tailSin,
+                                    position.y + back.x * tailSin + back.y * tailCos};
+                Vector2 tailRight = {position.x + back.x * tailCos + back.y * tailSin,
+                                     position.y - back.x * tailSin + back.y * tailCos};
+                AddTriangle(head, tailLeft, tailRight, Fade(color, 0.5f));
+            } break;
+            case EnemyShape::ARMORED: {
+                AddCircle(position, radius, color);
+                AddRing(position, radius * 0.6f, radius * 0.95f, Fade(flash, 0.65f), CircleTemplate::Ring());
+                AddCircle(position, radius * 0.4f, outline);
+            } break;
+        }
+    }
+}
+
+inline void DrawList::AddBullets(const FixedPool<Bullet>& bullets, float alpha) {
+    for (const Bullet& bullet : bullets) {
+        AddCircle(Vector2Lerp(bullet.previousPosition, bullet.position, alpha), bullet.radius, bullet.color,
+                  CircleTemplate::Small());
+    }
+}
+
+inline void DrawList::AddExplosions(const std::vector<Explosion>& explosions) {
+    for (const Explosion& explosion : explosions) {
+        float t = explosion.elapsed / explosion.lifetime;
+        if (t > 1.f) t = 1.f;
+        Color ringColor = {255, 200, 80, static_cast<unsigned char>(220 * (1.f - t))};
+        AddRing(explosion.position, explosion.radius * 0.2f, explosion.radius, Fade(ringColor, 0.8f));
+        AddCircle(explosion.position, explosion.radius * (0.3f + 0.3f * (1.f - t)),
+                  Fade((Color){255, 150, 70, 120}, 0.6f * (1.f - t)));
+    }
+}
+
+inline void DrawList::Submit() const {
+    for (const DrawBatch& batch : batches) {
+        rlCheckRenderBatchLimit(batch.count);
+        rlBegin(RL_TRIANGLES);
+        for (int v = batch.first; v < batch.first + batch.count; v++) {
+            const DrawVertex& vertex = vertices[v];
+            rlColor4ub(vertex.color.r, vertex.color.g, vertex.color.b, vertex.color.a);
+            rlVertex2f(vertex.x, vertex.y);
+        }
+        rlEnd();
+    }
+}
@@ -0,0 +1,445 @@
+#pragma once
+
+#include "raylib.h"
+#include "raymath.h"
+#include "fast_math.h"
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+#if defined(FAST_MATH_AVX2)
+#define ENEMY_KERNEL_AVX2 1
+#elif defined(FAST_MATH_SSE2)
+#define ENEMY_KERNEL_SSE2 1
+#endif
+
+// =====================================================
+// Enemy storage
+// Enemy is the spawn/draw record. Live enemies sit in EnemyStore, one stream per
+// field, so the movement kernel walks flat float arrays in SIMD-width batches.
+// =====================================================
+
+enum class EnemyType : uint8_t {
+    GRUNT,
+    RUNNER,
+    TANK
+};
+
+// ---------------- Archetypes ----------------
+// Everything an enemy type shares lives in one constexpr row indexed by EnemyType; a new
+// type is a new row (plus its sway/surge rule in the movement kernel if it moves differently).
+enum class EnemyShape : uint8_t {
+    ROUND,   // filled circle with an inner ring
+    DART,    // square body with a tail pointing away from its heading
+    ARMORED  // circle with a thick ring and a dark core
+};
+
+struct EnemyArchetype {
+    int baseHealth;
+    float baseSpeed;
+    float speedFactor;  // applied after the wave scale
+    float radius;
+    int baseContactDamage;
+    float knockbackResistance;
+    EnemyShape shape;
+    Color baseColor;
+    Color flashColor;
+};
+
+constexpr int enemyArchetypeCount = 3;
+constexpr EnemyArchetype enemyArchetypes[enemyArchetypeCount] = {
+    {45, 90.f, 1.f, 16.f, 12, 0.25f, EnemyShape::ROUND, {200, 60, 60, 255}, {255, 200, 120, 255}},     // GRUNT
+    {28, 140.f, 1.f, 12.f, 9, 0.05f, EnemyShape::DART, {80, 200, 255, 255}, {240, 255, 255, 255}},     // RUNNER
+    {110, 60.f, 0.85f, 22.f, 20, 0.7f, EnemyShape::ARMORED, {90, 70, 150, 255}, {190, 160, 255, 255}}  // TANK
+};
+
+inline const EnemyArchetype& GetEnemyArchetype(uint8_t archetype) { return enemyArchetypes[archetype]; }
+inline const EnemyArchetype& GetEnemyArchetype(EnemyType type) { return enemyArchetypes[static_cast<uint8_t>(type)]; }
+
+// Health, speed and contact damage of every archetype at one wave, computed once when the
+// wave starts so spawning is a lookup.
+struct EnemyWaveStats {
+    int wave = 0;
+    int health[enemyArchetypeCount];
+    float speed[enemyArchetypeCount];
+    int contactDamage[enemyArchetypeCount];
+};
+
+inline EnemyWaveStats ScaleEnemyArchetypes(int wave) {
+    EnemyWaveStats stats;
+    stats.wave = wave;
+    float healthScale = 1.f + (wave - 1) * 0.18f;
+    float speedScale = 1.f + (wave - 1) * 0.05f;
+    float damageScale = 1.f + (wave - 1) * 0.1f;
+    for (int i = 0; i < enemyArchetypeCount; i++) {
+        const EnemyArchetype& archetype = enemyArchetypes[i];
+        int health = static_cast<int>(std::round(archetype.baseHealth * healthScale));
+        int contactDamage = static_cast<int>(std::round(archetype.baseContactDamage * damageScale));
+        stats.health[i] = health < 1 ? 1 : health;
+        stats.speed[i] = archetype.baseSpeed * speedScale * archetype.speedFactor;
+        stats.contactDamage[i] = contactDamage < 1 ? 1 : contactDamage;
+    }
+    return stats;
+}
+
+// ---------------- Enemy ----------------
+class Enemy {
+public:
+    EnemyType type;  // archetype index
+    Vector2 position;
+    Vector2 facing;
+    int health;
+    float speed;
+    float radius;
+    float flashTimer;
+    float behaviorTimer;
+
+    Enemy() = default;
+    // behaviorPhase seeds the sway/surge timer (radians); callers draw it from their RNG stream.
+    Enemy(Vector2 spawnPos, EnemyType enemyType, const EnemyWaveStats& stats, float behaviorPhase)
+        : type(enemyType), position(spawnPos), facing({1.f, 0.f}),
+          health(stats.health[static_cast<uint8_t>(enemyType)]), speed(stats.speed[static_cast<uint8_t>(enemyType)]),
+          radius(GetEnemyArchetype(enemyType).radius), flashTimer(0.f), behaviorTimer(behaviorPhase) {}
+    // Scales the archetype for one enemy; spawners that place many should reuse one EnemyWaveStats.
+    Enemy(Vector2 spawnPos, EnemyType enemyType, int wave, float behaviorPhase)
+        : Enemy(spawnPos, enemyType, ScaleEnemyArchetypes(wave), behaviorPhase) {}
+    const EnemyArchetype& Archetype() const { return GetEnemyArchetype(type); }
+    void Draw() const;
+};
+
+inline void Enemy::Draw() const {
+    const EnemyArchetype& archetype = Archetype();
+    Color flashColor = archetype.flashColor;
+    Color color = flashTimer > 0.f ? flashColor : archetype.baseColor;
+    switch (archetype.shape) {
+        case EnemyShape::ROUND: {
+            DrawCircleV(position, radius, color);
+            DrawCircleLines(static_cast<int>(position.x), static_cast<int>(position.y), radius, Fade(BLACK, 0.5f));
+            DrawCircleLines(static_cast<int>(position.x), static_cast<int>(position.y), radius * 0.55f, Fade(flashColor, 0.4f));
+        } break;
+        case EnemyShape::DART: {
+            float angle = FastAtan2(facing.y, facing.x) * RAD2DEG;
+            DrawPoly(position, 4, radius * 1.2f, angle, color);
+            Vector2 head = Vector2Add(position, Vector2Scale(facing, radius * 1.2f));
+            Vector2 tailLeft = Vector2Add(position, Vector2Rotate(Vector2Scale(facing, -radius * 1.6f), 0.6f));
+            Vector2 tailRight = Vector2Add(position, Vector2Rotate(Vector2Scale(facing, -radius * 1.6f), -0.6f));
+            DrawTriangle(head, tailLeft, tailRight, Fade(color, 0.5f));
+        } break;
+        case EnemyShape::ARMORED: {
+            DrawCircleV(position, radius, color);
+            DrawRing(position, radius * 0.6f, radius * 0.95f, 0.f, 360.f, 24, Fade(flashColor, 0.65f));
+            DrawCircleV(position, radius * 0.4f, Fade(BLACK, 0.5f));
+        } break;
+    }
+}
+
+class EnemyStore {
+public:
+    // Hot streams: read and written by the movement kernel every frame.
+    std::vector<float> posX;
+    std::vector<float> posY;
+    std::vector<float> facingX;
+    std::vector<float> facingY;
+    std::vector<float> speed;
+    std::vector<float> timer;
+    std::vector<float> flashTimer;
+    std::vector<uint8_t> type;  // archetype index; shared stats come from enemyArchetypes
+    // Cold streams: only touched on contact, hits and drawing.
+    std::vector<float> radius;
+    std::vector<int> health;
+    std::vector<uint8_t> dead;  // killed this frame; dropped by RemoveDead
+    // Positions at the start of the last simulation step, for render interpolation.
+    std::vector<float> prevX;
+    std::vector<float> prevY;
+
+    size_t Size() const { return posX.size(); }
+    bool Empty() const { return posX.empty(); }
+    Vector2 Position(size_t i) const { return {posX[i], posY[i]}; }
+    Vector2 InterpolatedPosition(size_t i, float alpha) const {
+        return {prevX[i] + (posX[i] - prevX[i]) * alpha, prevY[i] + (posY[i] - prevY[i]) * alpha};
+    }
+    void SavePreviousPositions() {
+        prevX.assign(posX.begin(), posX.end());
+        prevY.assign(posY.begin(), posY.end());
+    }
+
+    void Clear();
+    void Reserve(size_t count);
+    void Push(const Enemy& enemy);
+    Enemy Get(size_t i) const;
+    void ApplyHit(size_t i, int damage, const Vector2& knockbackDir, float knockbackStrength);
+    void RemoveDead();
+
+private:
+    template <typename T>
+    static void Compact(std::vector<T>& stream, const std::vector<uint8_t>& dead) {
+        size_t write = 0;
+        for (size_t read = 0; read < stream.size(); read++) {
+            if (dead[read]) continue;
+            stream[write++] = stream[read];
+        }
+        stream.resize(write);
+    }
+};
+
+inline void EnemyStore::Clear() {
+    posX.clear(); posY.clear(); facingX.clear(); facingY.clear();
+    speed.clear(); timer.clear(); flashTimer.clear(); type.clear();
+    radius.clear(); health.clear(); dead.clear();
+    prevX.clear(); prevY.clear();
+}
+
+inline void EnemyStore::Reserve(size_t count) {
+    posX.reserve(count); posY.reserve(count); facingX.reserve(count); facingY.reserve(count);
+    speed.reserve(count); timer.reserve(count); flashTimer.reserve(count); type.reserve(count);
+    radius.reserve(count); health.reserve(count); dead.reserve(count);
+    prevX.reserve(count); prevY.reserve(count);
+}
+
+inline void EnemyStore::Push(const Enemy& enemy) {
+    posX.push_back(enemy.position.x);
+    posY.push_back(enemy.position.y);
+    facingX.push_back(enemy.facing.x);
+    facingY.push_back(enemy.facing.y);
+    speed.push_back(enemy.speed);
+    timer.push_back(enemy.behaviorTimer);
+    flashTimer.push_back(enemy.flashTimer);
+    type.push_back(static_cast<uint8_t>(enemy.type));
+    radius.push_back(enemy.radius);
+    health.push_back(enemy.health);
+    dead.push_back(0);
+    prevX.push_back(enemy.position.x);
+    prevY.push_back(enemy.position.y);
+}
+
+inline Enemy EnemyStore::Get(size_t i) const {
+    Enemy enemy;
+    enemy.type = static_cast<EnemyType>(type[i]);
+    enemy.position = {posX[i], posY[i]};
+    enemy.facing = {facingX[i], facingY[i]};
+    enemy.health = health[i];
+    enemy.speed = speed[i];
+    enemy.radius = radius[i];
+    enemy.flashTimer = flashTimer[i];
+    enemy.behaviorTimer = timer[i];
+    return enemy;
+}
+
+inline void EnemyStore::ApplyHit(size_t i, int damage, const Vector2& knockbackDir, float knockbackStrength) {
+    health[i] -= damage;
+    if (health[i] < 0) health[i] = 0;
+    flashTimer[i] = 0.12f;
+    float resistance = GetEnemyArchetype(type[i]).knockbackResistance;
+    if (resistance < 0.f) resistance = 0.f;
+    if (resistance > 0.95f) resistance = 0.95f;
+    if (knockbackStrength > 0.f && (knockbackDir.x != 0.f || knockbackDir.y != 0.f)) {
+        Vector2 dir = Vector2Normalize(knockbackDir);
+        float scaled = knockbackStrength * (1.f - resistance);
+        posX[i] += dir.x * scaled;
+        posY[i] += dir.y * scaled;
+    }
+}
+
+inline void EnemyStore::RemoveDead() {
+    Compact(posX, dead); Compact(posY, dead); Compact(facingX, dead); Compact(facingY, dead);
+    Compact(speed, dead); Compact(timer, dead); Compact(flashTimer, dead); Compact(type, dead);
+    Compact(radius, dead); Compact(health, dead);
+    Compact(prevX, dead); Compact(prevY, dead);
+    dead.assign(posX.size(), 0);
+}
+
+// ---------------- Movement kernel ----------------
+// Every enemy heads for the player. RUNNERs sway sideways with sin(6t), TANKs surge
+// with sin(1.5t). Both sinusoids repeat every 4*pi/3, so the timer wraps at that period
+// and the sine argument stays small enough for FastSin's polynomial (fast_math.h).
+//
+// The SIMD paths and the scalar fallback run the same float operations in the same
+// order (no rsqrt estimates), so results are bit-identical across instruction sets and
+// batch boundaries. Builds that enable FMA should also pass -ffp-contract=off to keep it so.
+
+constexpr float kEnemyTimerPeriod = 4.18879032f;  // 4*pi/3
+// targetX/targetY, when given, hold a per-enemy steering point (flow-field waypoints)
+// that replaces the player position; indices match the store.
+inline void UpdateEnemyMovementScalar(EnemyStore& store, size_t begin, size_t end, Vector2 playerPos, float delta,
+                                      const float* targetX = nullptr, const float* targetY = nullptr) {
+    const uint8_t runnerCode = static_cast<uint8_t>(EnemyType::RUNNER);
+    const uint8_t tankCode = static_cast<uint8_t>(EnemyType::TANK);
+    for (size_t i = begin; i < end; i++) {
+        float t = store.timer[i] + delta;
+        if (t >= kEnemyTimerPeriod) t = t - kEnemyTimerPeriod;
+        store.timer[i] = t;
+
+        float dx = (targetX ? targetX[i] : playerPos.x) - store.posX[i];
+        float dy = (targetY ? targetY[i] : playerPos.y) - store.posY[i];
+        float distance = std::sqrt(dx * dx + dy * dy);
+        bool far = distance > 0.001f;
+        float inv = 1.f / distance;
+        float dirX = far ? dx * inv : 0.f;
+        float dirY = far ? dy * inv : 0.f;
+
+        bool runner = store.type[i] == runnerCode;
+        bool tank = store.type[i] == tankCode;
+        float wave = FastSin(t * (runner ? 6.f : 1.5f));
+
+        float moveX = dirX;
+        float moveY = dirY;
+        if (runner && far) {
+            float sway = wave * 0.55f;
+            float rx = dirX + -dirY * sway;
+            float ry = dirY + dirX * sway;
+            float rlen = std::sqrt(rx * rx + ry * ry);
+            float rinv = 1.f / rlen;
+            moveX = rlen > 0.001f ? rx * rinv : rx;
+            moveY = rlen > 0.001f ? ry * rinv : ry;
+        } else if (tank) {
+            float pulse = 1.f + wave * 0.12f;
+            moveX = dirX * pulse;
+            moveY = dirY * pulse;
+        }
+
+        // The move direction is already unit length apart from the TANK pulse scale,
+        // so facing is the heading itself; it only holds still when standing on the player.
+        if (far) {
+            store.facingX[i] = (runner ? moveX : dirX);
+            store.facingY[i] = (runner ? moveY : dirY);
+        }
+        float step = store.speed[i] * delta;
+        store.posX[i] = store.posX[i] + moveX * step;
+        store.posY[i] = store.posY[i] + moveY * step;
+
+        float flash = store.flashTimer[i] - delta;
+        store.flashTimer[i] = flash > 0.f ? flash : 0.f;
+    }
+}
+
+// Moves enemies [begin, end). Batches go through the widest SIMD path compiled in;
+// the tail (and builds without SSE2) fall back to the scalar loop.
+inline void UpdateEnemyMovement(EnemyStore& store, size_t begin, size_t end, Vector2 playerPos, float delta,
+                                const float* targetX = nullptr, const float* targetY = nullptr) {
+    size_t i = begin;
+#if defined(ENEMY_KERNEL_AVX2)
+    const __m256 px = _mm256_set1_ps(playerPos.x);
+    const __m256 py = _mm256_set1_ps(playerPos.y);
+    const __m256 dt = _mm256_set1_ps(delta);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 signBit = _mm256_set1_ps(-0.f);
+    const __m256 one = _mm256_set1_ps(1.f);
+    const __m256 epsilon = _mm256_set1_ps(0.001f);
+    const __m256 period = _mm256_set1_ps(kEnemyTimerPeriod);
+    const __m256i runnerCode = _mm256_set1_epi32(static_cast<int>(EnemyType::RUNNER));
+    const __m256i tankCode = _mm256_set1_epi32(static_cast<int>(EnemyType::TANK));
+    for (; i + 8 <= end; i += 8) {
+        __m256 t = _mm256_add_ps(_mm256_loadu_ps(&store.timer[i]), dt);
+        t = FastMathSelect(_mm256_cmp_ps(t, period, _CMP_GE_OQ), _mm256_sub_ps(t, period), t);
+        _mm256_storeu_ps(&store.timer[i], t);
+
+        __m256 x = _mm256_loadu_ps(&store.posX[i]);
+        __m256 y = _mm256_loadu_ps(&store.posY[i]);
+        __m256 dx = _mm256_sub_ps(targetX ? _mm256_loadu_ps(&targetX[i]) : px, x);
+        __m256 dy = _mm256_sub_ps(targetY ? _mm256_loadu_ps(&targetY[i]) : py, y);
+        __m256 distance = _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)));
+        __m256 far = _mm256_cmp_ps(distance, epsilon, _CMP_GT_OQ);
+        __m256 inv = _mm256_div_ps(one, distance);
+        __m256 dirX = _mm256_and_ps(far, _mm256_mul_ps(dx, inv));
+        __m256 dirY = _mm256_and_ps(far, _mm256_mul_ps(dy, inv));
+
+        __m256i codes = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(&store.type[i])));
+        __m256 runner = _mm256_castsi256_ps(_mm256_cmpeq_epi32(codes, runnerCode));
+        __m256 tank = _mm256_castsi256_ps(_mm256_cmpeq_epi32(codes, tankCode));
+        __m256 wave = FastSin8(_mm256_mul_ps(t, FastMathSelect(runner, _mm256_set1_ps(6.f), _mm256_set1_ps(1.5f))));
+
+        __m256 sway = _mm256_mul_ps(wave, _mm256_set1_ps(0.55f));
+        __m256 rx = _mm256_add_ps(dirX, _mm256_mul_ps(_mm256_xor_ps(dirY, signBit), sway));
+        __m256 ry = _mm256_add_ps(dirY, _mm256_mul_ps(dirX, sway));
+        __m256 rlen = _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(rx, rx), _mm256_mul_ps(ry, ry)));
+        __m256 rinv = _mm256_div_ps(one, rlen);
+        __m256 rnorm = _mm256_cmp_ps(rlen, epsilon, _CMP_GT_OQ);
+        rx = FastMathSelect(rnorm, _mm256_mul_ps(rx, rinv), rx);
+        ry = FastMathSelect(rnorm, _mm256_mul_ps(ry, rinv), ry);
+
+        __m256 pulse = _mm256_add_ps(one, _mm256_mul_ps(wave, _mm256_set1_ps(0.12f)));
+        __m256 moveX = FastMathSelect(tank, _mm256_mul_ps(dirX, pulse), dirX);
+        __m256 moveY = FastMathSelect(tank, _mm256_mul_ps(dirY, pulse), dirY);
+        __m256 useRunner = _mm256_and_ps(runner, far);
+        moveX = FastMathSelect(useRunner, rx, moveX);
+        moveY = FastMathSelect(useRunner, ry, moveY);
+
+        __m256 headingX = FastMathSelect(runner, moveX, dirX);
+        __m256 headingY = FastMathSelect(runner, moveY, dirY);
+        _mm256_storeu_ps(&store.facingX[i], FastMathSelect(far, headingX, _mm256_loadu_ps(&store.facingX[i])));
+        _mm256_storeu_ps(&store.facingY[i], FastMathSelect(far, headingY, _mm256_loadu_ps(&store.facingY[i])));
+
+        __m256 step = _mm256_mul_ps(_mm256_loadu_ps(&store.speed[i]), dt);
+        _mm256_storeu_ps(&store.posX[i], _mm256_add_ps(x, _mm256_mul_ps(moveX, step)));
+        _mm256_storeu_ps(&store.posY[i], _mm256_add_ps(y, _mm256_mul_ps(moveY, step)));
+
+        __m256 flash = _mm256_sub_ps(_mm256_loadu_ps(&store.flashTimer[i]), dt);
+        _mm256_storeu_ps(&store.flashTimer[i], _mm256_and_ps(_mm256_cmp_ps(flash, zero, _CMP_GT_OQ), flash));
+    }
+#elif defined(ENEMY_KERNEL_SSE2)
+    const __m128 px = _mm_set1_ps(playerPos.x);
+    const __m128 py = _mm_set1_ps(playerPos.y);
+    const __m128 dt = _mm_set1_ps(delta);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 signBit = _mm_set1_ps(-0.f);
+    const __m128 one = _mm_set1_ps(1.f);
+    const __m128 epsilon = _mm_set1_ps(0.001f);
+    const __m128 period = _mm_set1_ps(kEnemyTimerPeriod);
+    const __m128i runnerCode = _mm_set1_epi32(static_cast<int>(EnemyType::RUNNER));
+    const __m128i tankCode = _mm_set1_epi32(static_cast<int>(EnemyType::TANK));
+    const __m128i zeroi = _mm_setzero_si128();
+    for (; i + 4 <= end; i += 4) {
+        __m128 t = _mm_add_ps(_mm_loadu_ps(&store.timer[i]), dt);
+        t = FastMathSelect(_mm_cmpge_ps(t, period), _mm_sub_ps(t, period), t);
+        _mm_storeu_ps(&store.timer[i], t);
+
+        __m128 x = _mm_loadu_ps(&store.posX[i]);
+        __m128 y = _mm_loadu_ps(&store.posY[i]);
+        __m128 dx = _mm_sub_ps(targetX ? _mm_loadu_ps(&targetX[i]) : px, x);
+        __m128 dy = _mm_sub_ps(targetY ? _mm_loadu_ps(&targetY[i]) : py, y);
+        __m128 distance = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)));
+        __m128 far = _mm_cmpgt_ps(distance, epsilon);
+        __m128 inv = _mm_div_ps(one, distance);
+        __m128 dirX = _mm_and_ps(far, _mm_mul_ps(dx, inv));
+        __m128 dirY = _mm_and_ps(far, _mm_mul_ps(dy, inv));
+
+        int packed;
+        std::memcpy(&packed, &store.type[i], sizeof(packed));
+        __m128i codes = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(packed), zeroi), zeroi);
+        __m128 runner = _mm_castsi128_ps(_mm_cmpeq_epi32(codes, runnerCode));
+        __m128 tank = _mm_castsi128_ps(_mm_cmpeq_epi32(codes, tankCode));
+        __m128 wave = FastSin4(_mm_mul_ps(t, FastMathSelect(runner, _mm_set1_ps(6.f), _mm_set1_ps(1.5f))));
+
+        __m128 sway = _mm_mul_ps(wave, _mm_set1_ps(0.55f));
+        __m128 rx = _mm_add_ps(dirX, _mm_mul_ps(_mm_xor_ps(dirY, signBit), sway));
+        __m128 ry = _mm_add_ps(dirY, _mm_mul_ps(dirX, sway));
+        __m128 rlen = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(rx, rx), _mm_mul_ps(ry, ry)));
+        __m128 rinv = _mm_div_ps(one, rlen);
+        __m128 rnorm = _mm_cmpgt_ps(rlen, epsilon);
+        rx = FastMathSelect(rnorm, _mm_mul_ps(rx, rinv), rx);
+        ry = FastMathSelect(rnorm, _mm_mul_ps(ry, rinv), ry);
+
+        __m128 pulse = _mm_add_ps(one, _mm_mul_ps(wave, _mm_set1_ps(0.12f)));
+        __m128 moveX = FastMathSelect(tank, _mm_mul_ps(dirX, pulse), dirX);
+        __m128 moveY = FastMathSelect(tank, _mm_mul_ps(dirY, pulse), dirY);
+        __m128 useRunner = _mm_and_ps(runner, far);
+        moveX = FastMathSelect(useRunner, rx, moveX);
+        moveY = FastMathSelect(useRunner, ry, moveY);
+
+        __m128 headingX = FastMathSelect(runner, moveX, dirX);
+        __m128 headingY = FastMathSelect(runner, moveY, dirY);
+        _mm_storeu_ps(&store.facingX[i], FastMathSelect(far, headingX, _mm_loadu_ps(&store.facingX[i])));
+        _mm_storeu_ps(&store.facingY[i], FastMathSelect(far, headingY, _mm_loadu_ps(&store.facingY[i])));
+
+        __m128 step = _mm_mul_ps(_mm_loadu_ps(&store.speed[i]), dt);
+        _mm_storeu_ps(&store.posX[i], _mm_add_ps(x, _mm_mul_ps(moveX, step)));
+        _mm_storeu_ps(&store.posY[i], _mm_add_ps(y, _mm_mul_ps(moveY, step)));
+
+        __m128 flash = _mm_sub_ps(_mm_loadu_ps(&store.flashTimer[i]), dt);
+        _mm_storeu_ps(&store.flashTimer[i], _mm_and_ps(_mm_cmpgt_ps(flash, zero), flash));
+    }
+#endif
+    UpdateEnemyMovementScalar(store, i, end, playerPos, delta, targetX, targetY);
+}
@@ -0,0 +1,222 @@
+#pragma once
+
+#include "raylib.h"
+#include <cmath>
+#include <cstddef>
+
+#if !defined(WAVEBREAKER_NO_SIMD) && defined(__AVX2__)
+#include <immintrin.h>
+#define FAST_MATH_AVX2 1
+#elif !defined(WAVEBREAKER_NO_SIMD) && defined(__SSE2__)
+#include <emmintrin.h>
+#define FAST_MATH_SSE2 1
+#endif
+
+// =====================================================
+// Fast math
+// Polynomial sin/cos/atan2 for hot paths that don't need libm's last bit, batch
+// versions over flat arrays, and rotation by precomputed unit vectors. The SSE2/AVX2
+// forms (used by the batches and the enemy kernel) run the same float operations in the
+// same order as the scalar ones, so every path gives bit-identical results (builds that
+// enable FMA should pass -ffp-contract=off to keep it so).
+//
+// Error bounds against double-precision libm (checked by the fast math bench line):
+//   FastSin, FastCos   |error| <= 1e-6 for |x| <= 2*pi. The reduction works on x / 2pi in
+//                      float, so beyond that the bound grows to 1.5e-7 * |x|;
+//                      wrap long-running phases with WrapPhase first.
+//   FastAtan2          |error| <= 3e-6 rad (under 0.0002 degrees); FastAtan2(0, 0) is 0.
+// =====================================================
+
+constexpr float kInvTwoPi = 0.159154943f;
+// sin(2*pi*t) for t in [-0.25, 0.25]; odd Taylor series to t^11, |error| < 1e-7.
+constexpr float kSinC1 = 6.28318531f;
+constexpr float kSinC3 = -41.3417022f;
+constexpr float kSinC5 = 81.6052499f;
+constexpr float kSinC7 = -76.7058597f;
+constexpr float kSinC9 = 42.0586940f;
+constexpr float kSinC11 = -15.0946426f;
+
+// atan(z) for z in [0, 1]; odd minimax polynomial to z^11.
+constexpr float kAtanC1 = 0.99997726f;
+constexpr float kAtanC3 = -0.33262347f;
+constexpr float kAtanC5 = 0.19354346f;
+constexpr float kAtanC7 = -0.11643287f;
+constexpr float kAtanC9 = 0.05265332f;
+constexpr float kAtanC11 = -0.01172120f;
+constexpr float kHalfPi = 1.57079633f;
+constexpr float kPi = 3.14159265f;
+
+// Round to nearest, ties to even, like nearbyint in the default rounding mode, but
+// without the library call: adding 1.5 * 2^23 pushes the fraction out of the mantissa.
+// Exact for |t| < 2^22, far beyond any argument here. Needs IEEE float semantics
+// (no -ffast-math, which would fold the add and subtract away).
+constexpr float kRoundMagic = 12582912.f;
+inline float FastRoundNearest(float t) { return (t + kRoundMagic) - kRoundMagic; }
+
+// sin(2*pi*t) with t in turns; the shared core of FastSin and FastCos.
+inline float FastSinTurns(float t) {
+    t = t - FastRoundNearest(t);
+    if (t > 0.25f) t = 0.5f - t;
+    if (t < -0.25f) t = -0.5f - t;
+    float t2 = t * t;
+    float p = kSinC11;
+    p = p * t2 + kSinC9;
+    p = p * t2 + kSinC7;
+    p = p * t2 + kSinC5;
+    p = p * t2 + kSinC3;
+    p = p * t2 + kSinC1;
+    return t * p;
+}
+
+inline float FastSin(float x) { return FastSinTurns(x * kInvTwoPi); }
+inline float FastCos(float x) { return FastSinTurns(x * kInvTwoPi + 0.25f); }
+
+inline float FastAtan2(float y, float x) {
+    float ax = std::fabs(x);
+    float ay = std::fabs(y);
+    float hi = ax > ay ? ax : ay;
+    float lo = ax > ay ? ay : ax;
+    float z = hi > 0.f ? lo / hi : 0.f;
+    float z2 = z * z;
+    float p = kAtanC11;
+    p = p * z2 + kAtanC9;
+    p = p * z2 + kAtanC7;
+    p = p * z2 + kAtanC5;
+    p = p * z2 + kAtanC3;
+    p = p * z2 + kAtanC1;
+    float r = z * p;
+    r = ay > ax ? kHalfPi - r : r;
+    r = x < 0.f ? kPi - r : r;
+    return std::signbit(y) ? -r : r;
+}
+
+// Reduces a phase kept in double (GetTime() * rate) to [0, 2pi) before it is narrowed,
+// so the float sine stays accurate however long the game has run.
+inline float WrapPhase(double radians) {
+    double wrapped = std::fmod(radians, 2.0 * PI);
+    return static_cast<float>(wrapped < 0.0 ? wrapped + 2.0 * PI : wrapped);
+}
+
+#if defined(FAST_MATH_AVX2)
+inline __m256 FastMathSelect(__m256 mask, __m256 a, __m256 b) { return _mm256_blendv_ps(b, a, mask); }
+
+inline __m256 FastSinTurns8(__m256 t) {
+    t = _mm256_sub_ps(t, _mm256_round_ps(t, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+    t = FastMathSelect(_mm256_cmp_ps(t, _mm256_set1_ps(0.25f), _CMP_GT_OQ), _mm256_sub_ps(_mm256_set1_ps(0.5f), t), t);
+    t = FastMathSelect(_mm256_cmp_ps(t, _mm256_set1_ps(-0.25f), _CMP_LT_OQ), _mm256_sub_ps(_mm256_set1_ps(-0.5f), t), t);
+    __m256 t2 = _mm256_mul_ps(t, t);
+    __m256 p = _mm256_set1_ps(kSinC11);
+    p = _mm256_add_ps(_mm256_mul_ps(p, t2), _mm256_set1_ps(kSinC9));
+    p = _mm256_add_ps(_mm256_mul_ps(p, t2), _mm256_set1_ps(kSinC7));
+    p = _mm256_add_ps(_mm256_mul_ps(p, t2), _mm256_set1_ps(kSinC5));
+    p = _mm256_add_ps(_mm256_mul_ps(p, t2), _mm256_set1_ps(kSinC3));
+    p = _mm256_add_ps(_mm256_mul_ps(p, t2), _mm256_set1_ps(kSinC1));
+    return _mm256_mul_ps(t, p);
+}
+
+inline __m256 FastSin8(__m256 x) { return FastSinTurns8(_mm256_mul_ps(x, _mm256_set1_ps(kInvTwoPi))); }
+
+inline __m256 FastAtan2x8(__m256 y, __m256 x) {
+    const __m256 signBit = _mm256_set1_ps(-0.f);
+    __m256 ax = _mm256_andnot_ps(signBit, x);
+    __m256 ay = _mm256_andnot_ps(signBit, y);
+    __m256 hi = _mm256_max_ps(ax, ay);
+    __m256 lo = _mm256_min_ps(ay, ax);
+    __m256 z = FastMathSelect(_mm256_cmp_ps(hi, _mm256_setzero_ps(), _CMP_GT_OQ), _mm256_div_ps(lo, hi), _mm256_setzero_ps());
+    __m256 z2 = _mm256_mul_ps(z, z);
+    __m256 p = _mm256_set1_ps(kAtanC11);
+    p = _mm256_add_ps(_mm256_mul_ps(p, z2), _mm256_set1_ps(kAtanC9));
+    p = _mm256_add_ps(_mm256_mul_ps(p, z2), _mm256_set1_ps(kAtanC7));
+    p = _mm256_add_ps(_mm256_mul_ps(p, z2), _mm256_set1_ps(kAtanC5));
+    p = _mm256_add_ps(_mm256_mul_ps(p, z2), _mm256_set1_ps(kAtanC3));
+    p = _mm256_add_ps(_mm256_mul_ps(p, z2), _mm256_set1_ps(kAtanC1));
+    __m256 r = _mm256_mul_ps(z, p);
+    r = FastMathSelect(_mm256_cmp_ps(ay, ax, _CMP_GT_OQ), _mm256_sub_ps(_mm256_set1_ps(kHalfPi), r), r);
+    r = FastMathSelect(_mm256_cmp_ps(x, _mm256_setzero_ps(), _CMP_LT_OQ), _mm256_sub_ps(_mm256_set1_ps(kPi), r), r);
+    return _mm256_xor_ps(r, _mm256_and_ps(y, signBit));
+}
+#elif defined(FAST_MATH_SSE2)
+inline __m128 FastMathSelect(__m128 mask, __m128 a, __m128 b) {
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+inline __m128 FastSinTurns4(__m128 t) {
+    t = _mm_sub_ps(t, _mm_cvtepi32_ps(_mm_cvtps_epi32(t)));  // cvtps rounds to nearest-even
+    t = FastMathSelect(_mm_cmpgt_ps(t, _mm_set1_ps(0.25f)), _mm_sub_ps(_mm_set1_ps(0.5f), t), t);
+    t = FastMathSelect(_mm_cmplt_ps(t, _mm_set1_ps(-0.25f)), _mm_sub_ps(_mm_set1_ps(-0.5f), t), t);
+    __m128 t2 = _mm_mul_ps(t, t);
+    __m128 p = _mm_set1_ps(kSinC11);
+    p = _mm_add_ps(_mm_mul_ps(p, t2), _mm_set1_ps(kSinC9));
+    p = _mm_add_ps(_mm_mul_ps(p, t2), _mm_set1_ps(kSinC7));
+    p = _mm_add_ps(_mm_mul_ps(p, t2), _mm_set1_ps(kSinC5));
+    p = _mm_add_ps(_mm_mul_ps(p, t2), _mm_set1_ps(kSinC3));
+    p = _mm_add_ps(_mm_mul_ps(p, t2), _mm_set1_ps(kSinC1));
+    return _mm_mul_ps(t, p);
+}
+
+inline __m128 FastSin4(__m128 x) { return FastSinTurns4(_mm_mul_ps(x, _mm_set1_ps(kInvTwoPi))); }
+
+inline __m128 FastAtan2x4(__m128 y, __m128 x) {
+    const __m128 signBit = _mm_set1_ps(-0.f);
+    __m128 ax = _mm_andnot_ps(signBit, x);
+    __m128 ay = _mm_andnot_ps(signBit, y);
+    __m128 hi = _mm_max_ps(ax, ay);
+    __m128 lo = _mm_min_ps(ay, ax);
+    __m128 z = FastMathSelect(_mm_cmpgt_ps(hi, _mm_setzero_ps()), _mm_div_ps(lo, hi), _mm_setzero_ps());
+    __m128 z2 = _mm_mul_ps(z, z);
+    __m128 p = _mm_set1_ps(kAtanC11);
+    p = _mm_add_ps(_mm_mul_ps(p, z2), _mm_set1_ps(kAtanC9));
+    p = _mm_add_ps(_mm_mul_ps(p, z2), _mm_set1_ps(kAtanC7));
+    p = _mm_add_ps(_mm_mul_ps(p, z2), _mm_set1_ps(kAtanC5));
+    p = _mm_add_ps(_mm_mul_ps(p, z2), _mm_set1_ps(kAtanC3));
+    p = _mm_add_ps(_mm_mul_ps(p, z2), _mm_set1_ps(kAtanC1));
+    __m128 r = _mm_mul_ps(z, p);
+    r = FastMathSelect(_mm_cmpgt_ps(ay, ax), _mm_sub_ps(_mm_set1_ps(kHalfPi), r), r);
+    r = FastMathSelect(_mm_cmplt_ps(x, _mm_setzero_ps()), _mm_sub_ps(_mm_set1_ps(kPi), r), r);
+    return _mm_xor_ps(r, _mm_and_ps(y, signBit));
+}
+#endif
+
+// Batch forms over flat arrays: the widest SIMD path compiled in, scalar for the tail.
+// Element for element they match the scalar functions exactly.
+inline void FastSinCosBatch(const float* angles, float* sinOut, float* cosOut, size_t count) {
+    size_t i = 0;
+#if defined(FAST_MATH_AVX2)
+    for (; i + 8 <= count; i += 8) {
+        __m256 t = _mm256_mul_ps(_mm256_loadu_ps(angles + i), _mm256_set1_ps(kInvTwoPi));
+        _mm256_storeu_ps(sinOut + i, FastSinTurns8(t));
+        _mm256_storeu_ps(cosOut + i, FastSinTurns8(_mm256_add_ps(t, _mm256_set1_ps(0.25f))));
+    }
+#elif defined(FAST_MATH_SSE2)
+    for (; i + 4 <= count; i += 4) {
+        __m128 t = _mm_mul_ps(_mm_loadu_ps(angles + i), _mm_set1_ps(kInvTwoPi));
+        _mm_storeu_ps(sinOut + i, FastSinTurns4(t));
+        _mm_storeu_ps(cosOut + i, FastSinTurns4(_mm_add_ps(t, _mm_set1_ps(0.25f))));
+    }
+#endif
+    for (; i < count; i++) {
+        float t = angles[i] * kInvTwoPi;
+        sinOut[i] = FastSinTurns(t);
+        cosOut[i] = FastSinTurns(t + 0.25f);
+    }
+}
+
+inline void FastAtan2Batch(const float* y, const float* x, float* out, size_t count) {
+    size_t i = 0;
+#if defined(FAST_MATH_AVX2)
+    for (; i + 8 <= count; i += 8) _mm256_storeu_ps(out + i, FastAtan2x8(_mm256_loadu_ps(y + i), _mm256_loadu_ps(x + i)));
+#elif defined(FAST_MATH_SSE2)
+    for (; i + 4 <= count; i += 4) _mm_storeu_ps(out + i, FastAtan2x4(_mm_loadu_ps(y + i), _mm_loadu_ps(x + i)));
+#endif
+    for (; i < count; i++) out[i] = FastAtan2(y[i], x[i]);
+}
+
+// A fixed rotation as its unit vector, for angles known up front (e.g. spread offsets).
+struct UnitRotation {
+    float c;
+    float s;
+};
+
+inline UnitRotation MakeUnitRotation(float radians) { return {std::cos(radians), std::sin(radians)}; }
+
+inline Vector2 Rotate(Vector2 v, UnitRotation r) { return {v.x * r.c - v.y * r.s, v.x * r.s + v.y * r.c}; }
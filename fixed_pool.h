@@ -0,0 +1,79 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+// =====================================================
+// Fixed-capacity entity pool
+// Storage is allocated once by SetCapacity and never grows, so spawning and
+// despawning never touch the heap. Live items stay packed at the front in spawn
+// order (the free list is simply the tail past Size()), which keeps iteration
+// dense and preserves "oldest first" ordering for collision resolution.
+// A classic free list of recycled slots was the alternative. It would leave holes
+// that every pass over bullets has to skip, and a reused slot would break the
+// lowest-index-is-oldest rule the hit search depends on. Compacting costs one
+// RemoveIf pass per step, which Step pays once after collisions anyway.
+// =====================================================
+template <typename T>
+class FixedPool {
+public:
+    FixedPool() = default;
+    explicit FixedPool(size_t capacity) { SetCapacity(capacity); }
+
+    // Reallocates; only call during setup, never mid-frame.
+    void SetCapacity(size_t capacity) {
+        std::vector<T> fresh;
+        fresh.reserve(capacity);
+        for (size_t i = 0; i < items.size() && i < capacity; i++) fresh.push_back(items[i]);
+        items.swap(fresh);
+        limit = capacity;
+    }
+
+    // Returns nullptr (and counts a drop) when the pool is full.
+    T* Push(const T& item) {
+        if (items.size() >= limit) {
+            dropped++;
+            return nullptr;
+        }
+        items.push_back(item);
+        if (items.size() > highWater) highWater = items.size();
+        return &items.back();
+    }
+
+    // Stable removal in one pass; survivors keep their spawn order.
+    template <typename IsDeadFn>
+    void RemoveIf(IsDeadFn isDead) {
+        size_t write = 0;
+        for (size_t read = 0; read < items.size(); read++) {
+            if (isDead(items[read])) continue;
+            if (write != read) items[write] = items[read];
+            write++;
+        }
+        while (items.size() > write) items.pop_back();
+    }
+
+    void Clear() { items.clear(); }
+
+    size_t Size() const { return items.size(); }
+    bool Empty() const { return items.empty(); }
+    size_t Capacity() const { return limit; }
+    size_t HighWater() const { return highWater; }
+    size_t Dropped() const { return dropped; }
+    void ResetStats() {
+        highWater = items.size();
+        dropped = 0;
+    }
+
+    T& operator[](size_t i) { return items[i]; }
+    const T& operator[](size_t i) const { return items[i]; }
+    T* begin() { return items.data(); }
+    T* end() { return items.data() + items.size(); }
+    const T* begin() const { return items.data(); }
+    const T* end() const { return items.data() + items.size(); }
+
+private:
+    std::vector<T> items;  // capacity fixed at `limit`; push_back never reallocates
+    size_t limit = 0;
+    size_t highWater = 0;
+    size_t dropped = 0;
+};
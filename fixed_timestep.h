@@ -0,0 +1,49 @@
+#pragma once
+
+// =====================================================
+// Fixed-timestep accumulator
+// Frame time is banked and spent in whole simulation steps, so the sim runs at
+// the same rate on a 30 Hz phone and a 144 Hz monitor. A hitch is capped at
+// maxStepsPerFrame steps and the rest is dropped, which keeps a slow frame from
+// snowballing into ever longer catch-up frames. Alpha() is the leftover fraction
+// of a step, used to interpolate between the previous and current positions.
+// =====================================================
+class FixedTimestep {
+public:
+    explicit FixedTimestep(float stepsPerSecond = 120.f, int maxStepsPerFrame = 8)
+        : rate(stepsPerSecond), step(1.f / stepsPerSecond), maxSteps(maxStepsPerFrame) {}
+
+    // Banks frameTime and returns how many steps to run this frame.
+    int Advance(float frameTime) {
+        if (frameTime < 0.f) frameTime = 0.f;
+        accumulator += frameTime;
+        int steps = static_cast<int>(accumulator / step);
+        if (steps > maxSteps) {
+            steps = maxSteps;
+            droppedSeconds += accumulator - step * static_cast<float>(maxSteps);
+            accumulator = step * static_cast<float>(maxSteps);
+        }
+        accumulator -= step * static_cast<float>(steps);
+        if (accumulator < 0.f) accumulator = 0.f;
+        return steps;
+    }
+
+    // Forget banked time, e.g. after a state change teleports everything.
+    void Reset() { accumulator = 0.f; }
+
+    float StepSeconds() const { return step; }
+    float StepsPerSecond() const { return rate; }
+    int MaxStepsPerFrame() const { return maxSteps; }
+    float Alpha() const {
+        float alpha = accumulator / step;
+        return alpha > 1.f ? 1.f : alpha;
+    }
+    float DroppedSeconds() const { return droppedSeconds; }
+
+private:
+    float rate;
+    float step;
+    int maxSteps;
+    float accumulator = 0.f;
+    float droppedSeconds = 0.f;
+};
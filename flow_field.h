@@ -0,0 +1,184 @@
+#pragma once
+
+#include "raylib.h"
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <climits>
+#include <algorithm>
+#include <functional>
+#include <utility>
+
+// =====================================================
+// Flow field toward the player
+// One shortest-path field over a uniform grid, shared by every enemy, so routing
+// around walls costs O(cells) per player cell change instead of a search per enemy.
+// Update rebuilds only when the player enters a new cell or the walls change. A cell
+// that can see the player's cell steers straight at the player, and any other cell
+// steers at the centre of the next cell on its path (Dijkstra with 8 neighbours,
+// costs 10/14, no corner cutting). With no walls every cell sees the player, so
+// Update is a cell comparison and enemies keep their exact beeline.
+// Positions outside the grid clamp to the border cells.
+// =====================================================
+class FlowField {
+public:
+    // Drops all walls.
+    void Reset(float width, float height, float cellSize);
+    // Marks (or clears) every cell the rectangle touches.
+    void SetBlocked(Rectangle area, bool blocked = true);
+    bool HasWalls() const { return wallCells > 0; }
+    bool Blocked(Vector2 position) const { return blocked[CellOf(position)] != 0; }
+
+    // Returns true if the field was rebuilt; never after the first call in an open arena.
+    bool Update(Vector2 playerPos);
+
+    // Point an enemy at `position` should head for this step.
+    Vector2 Target(Vector2 position, Vector2 playerPos) const {
+        int next = nextCell[CellOf(position)];
+        return next < 0 ? playerPos : CellCenter(next);
+    }
+
+    int Cols() const { return cols; }
+    int Rows() const { return rows; }
+    int Rebuilds() const { return rebuilds; }
+
+private:
+    float cellSize = 32.f;
+    float invCellSize = 1.f / 32.f;
+    int cols = 0;
+    int rows = 0;
+    int playerCell = -1;
+    int wallCells = 0;
+    int rebuilds = 0;
+    bool dirty = true;
+    std::vector<uint8_t> blocked;
+    std::vector<int> cost;      // path cost to the player's cell, INT_MAX when unreachable
+    std::vector<int> nextCell;  // next cell toward the player, -1 to steer straight at it
+    std::vector<std::pair<int, int>> open;  // (cost, cell) min-heap, reserved once
+
+    int CellX(float x) const { return std::max(0, std::min(cols - 1, static_cast<int>(std::floor(x * invCellSize)))); }
+    int CellY(float y) const { return std::max(0, std::min(rows - 1, static_cast<int>(std::floor(y * invCellSize)))); }
+    int CellOf(Vector2 p) const { return CellY(p.y) * cols + CellX(p.x); }
+    Vector2 CellCenter(int cell) const {
+        return {(static_cast<float>(cell % cols) + 0.5f) * cellSize, (static_cast<float>(cell / cols) + 0.5f) * cellSize};
+    }
+    bool LineOfSight(int from, int to) const;
+    void Rebuild();
+};
+
+inline void FlowField::Reset(float width, float height, float size) {
+    cellSize = size > 1.f ? size : 1.f;
+    invCellSize = 1.f / cellSize;
+    cols = std::max(1, static_cast<int>(std::ceil(width * invCellSize)));
+    rows = std::max(1, static_cast<int>(std::ceil(height * invCellSize)));
+    size_t cells = static_cast<size_t>(cols * rows);
+    blocked.assign(cells, 0);
+    cost.assign(cells, INT_MAX);
+    nextCell.assign(cells, -1);
+    open.clear();
+    open.reserve(cells * 8);  // every relaxation pushes at most once per neighbour
+    wallCells = 0;
+    playerCell = -1;
+    dirty = true;
+}
+
+inline void FlowField::SetBlocked(Rectangle area, bool block) {
+    int x0 = CellX(area.x), x1 = CellX(area.x + area.width);
+    int y0 = CellY(area.y), y1 = CellY(area.y + area.height);
+    for (int cy = y0; cy <= y1; cy++) {
+        for (int cx = x0; cx <= x1; cx++) {
+            uint8_t& cell = blocked[static_cast<size_t>(cy * cols + cx)];
+            if (cell == static_cast<uint8_t>(block)) continue;
+            cell = static_cast<uint8_t>(block);
+            wallCells += block ? 1 : -1;
+        }
+    }
+    dirty = true;
+}
+
+inline bool FlowField::Update(Vector2 playerPos) {
+    int cell = CellOf(playerPos);
+    if (cell == playerCell && !dirty) return false;
+    playerCell = cell;
+    bool wallsChanged = dirty;
+    dirty = false;
+    if (HasWalls()) {
+        Rebuild();
+    } else if (wallsChanged) {
+        std::fill(nextCell.begin(), nextCell.end(), -1);  // last wall removed
+    } else {
+        return false;  // open arena: every cell already beelines
+    }
+    rebuilds++;
+    return true;
+}
+
+// Walks the cells the segment between the two centres passes through (corners count as
+// both neighbours), so a diagonal squeeze between two walls never counts as visible.
+inline bool FlowField::LineOfSight(int from, int to) const {
+    int x = from % cols, y = from / cols;
+    int tx = to % cols, ty = to / cols;
+    int dx = std::abs(tx - x), dy = std::abs(ty - y);
+    int sx = tx > x ? 1 : -1, sy = ty > y ? 1 : -1;
+    int error = dx - dy;
+    while (x != tx || y != ty) {
+        if (blocked[static_cast<size_t>(y * cols + x)]) return false;
+        int twice = 2 * error;
+        if (twice > -dy && twice < dx) {
+            // Passing exactly through a corner: both side cells must be open.
+            if (blocked[static_cast<size_t>(y * cols + x + sx)] || blocked[static_cast<size_t>((y + sy) * cols + x)]) {
+                return false;
+            }
+            error += dx - dy;
+            x += sx;
+            y += sy;
+        } else if (twice > -dy) {
+            error -= dy;
+            x += sx;
+        } else {
+            error += dx;
+            y += sy;
+        }
+    }
+    return !blocked[static_cast<size_t>(to)];
+}
+
+inline void FlowField::Rebuild() {
+    std::fill(cost.begin(), cost.end(), INT_MAX);
+    std::fill(nextCell.begin(), nextCell.end(), -1);
+    open.clear();
+    cost[static_cast<size_t>(playerCell)] = 0;
+    open.push_back({0, playerCell});
+    static const int offsetX[8] = {1, -1, 0, 0, 1, 1, -1, -1};
+    static const int offsetY[8] = {0, 0, 1, -1, 1, -1, 1, -1};
+    while (!open.empty()) {
+        std::pop_heap(open.begin(), open.end(), std::greater<std::pair<int, int>>());
+        std::pair<int, int> top = open.back();
+        open.pop_back();
+        int cell = top.second;
+        if (top.first > cost[static_cast<size_t>(cell)]) continue;  // stale entry
+        int x = cell % cols, y = cell / cols;
+        for (int k = 0; k < 8; k++) {
+            int nx = x + offsetX[k], ny = y + offsetY[k];
+            if (nx < 0 || ny < 0 || nx >= cols || ny >= rows) continue;
+            int neighbour = ny * cols + nx;
+            if (blocked[static_cast<size_t>(neighbour)]) continue;
+            bool diagonal = k >= 4;
+            if (diagonal && (blocked[static_cast<size_t>(y * cols + nx)] || blocked[static_cast<size_t>(ny * cols + x)])) {
+                continue;
+            }
+            int candidate = top.first + (diagonal ? 14 : 10);
+            if (candidate >= cost[static_cast<size_t>(neighbour)]) continue;
+            cost[static_cast<size_t>(neighbour)] = candidate;
+            nextCell[static_cast<size_t>(neighbour)] = cell;
+            open.push_back({candidate, neighbour});
+            std::push_heap(open.begin(), open.end(), std::greater<std::pair<int, int>>());
+        }
+    }
+    // Cells that can see the player go straight for it; unreachable ones (sealed pockets,
+    // enemies knocked into a wall) keep -1 and beeline too.
+    for (size_t c = 0; c < nextCell.size(); c++) {
+        if (nextCell[c] >= 0 && LineOfSight(static_cast<int>(c), playerCell)) nextCell[c] = -1;
+    }
+}
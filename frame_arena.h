@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+// =====================================================
+// Frame arena
+// Bump allocator for data that only lives until the next Reset (one frame, or one
+// sim step). Allocation is an aligned pointer bump; freeing is a no-op and Reset
+// drops everything at once. If a frame needs more than the block holds, the rest
+// comes from the heap (counted as an overflow) and the block grows to the peak at
+// the next Reset, so the heap is only touched while the working set is still growing.
+// ArenaAllocator adapts it for STL containers. Single-threaded: job workers keep
+// their own buffers.
+// =====================================================
+
+class FrameArena {
+public:
+    explicit FrameArena(size_t capacity = 0) { Grow(capacity); }
+    // Copies start empty with the same capacity; scratch contents never carry over.
+    FrameArena(const FrameArena& other) : FrameArena(other.capacity) {}
+    FrameArena& operator=(const FrameArena& other) {
+        if (this != &other) {
+            overflow.clear();
+            offset = 0;
+            overflowBytes = 0;
+            if (other.capacity > capacity) Grow(other.capacity);
+        }
+        return *this;
+    }
+
+    void* Allocate(size_t bytes, size_t align = alignof(std::max_align_t));
+
+    // Frees every allocation. Blocks grow here, never while allocations are live.
+    void Reset();
+    // Block size wanted from the next Reset on (applied immediately while empty).
+    void Reserve(size_t bytes);
+
+    // printf into the arena; the string lives until Reset.
+    const char* Format(const char* format, ...);
+
+    size_t Used() const { return offset + overflowBytes; }
+    size_t Capacity() const { return capacity; }
+    size_t HighWater() const { return highWater; }
+    size_t Overflows() const { return overflowCount; }
+
+private:
+    std::unique_ptr<unsigned char[]> block;
+    size_t capacity = 0;
+    size_t offset = 0;
+    size_t wanted = 0;
+    size_t highWater = 0;
+    size_t overflowBytes = 0;
+    size_t overflowCount = 0;
+    std::vector<std::unique_ptr<unsigned char[]>> overflow;
+
+    void Grow(size_t bytes) {
+        if (bytes <= capacity) return;
+        block.reset(new unsigned char[bytes]);
+        capacity = bytes;
+    }
+};
+
+inline void* FrameArena::Allocate(size_t bytes, size_t align) {
+    uintptr_t base = reinterpret_cast<uintptr_t>(block.get());
+    size_t aligned = static_cast<size_t>(((base + offset + align - 1) & ~static_cast<uintptr_t>(align - 1)) - base);
+    if (block && aligned + bytes <= capacity) {
+        offset = aligned + bytes;
+        if (Used() > highWater) highWater = Used();
+        return block.get() + aligned;
+    }
+    overflow.emplace_back(new unsigned char[bytes + align]);
+    overflowBytes += bytes + align;
+    overflowCount++;
+    if (Used() > highWater) highWater = Used();
+    uintptr_t raw = reinterpret_cast<uintptr_t>(overflow.back().get());
+    return reinterpret_cast<void*>((raw + align - 1) & ~static_cast<uintptr_t>(align - 1));
+}
+
+inline void FrameArena::Reset() {
+    if (!overflow.empty()) {
+        // Grow past the peak with some headroom so a slowly rising load settles quickly.
+        size_t peak = offset + overflowBytes;
+        if (peak + peak / 4 > wanted) wanted = peak + peak / 4;
+        overflow.clear();
+    }
+    offset = 0;
+    overflowBytes = 0;
+    Grow(wanted);
+}
+
+inline void FrameArena::Reserve(size_t bytes) {
+    if (bytes > wanted) wanted = bytes;
+    if (offset == 0 && overflow.empty()) Grow(wanted);
+}
+
+inline const char* FrameArena::Format(const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    va_list measure;
+    va_copy(measure, args);
+    int length = vsnprintf(nullptr, 0, format, measure);
+    va_end(measure);
+    if (length < 0) length = 0;
+    char* text = static_cast<char*>(Allocate(static_cast<size_t>(length) + 1, 1));
+    vsnprintf(text, static_cast<size_t>(length) + 1, format, args);
+    va_end(args);
+    return text;
+}
+
+template <typename T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+
+    explicit ArenaAllocator(FrameArena& arena) : arena(&arena) {}
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.arena) {}
+
+    T* allocate(size_t count) { return static_cast<T*>(arena->Allocate(count * sizeof(T), alignof(T))); }
+    void deallocate(T*, size_t) {}
+
+    FrameArena* arena;
+};
+
+template <typename T, typename U>
+inline bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) { return a.arena == b.arena; }
+template <typename T, typename U>
+inline bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) { return a.arena != b.arena; }
+
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
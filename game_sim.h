@@ -0,0 +1,1601 @@
+#pragma once
+
+#include "raylib.h"
+#include "raymath.h"
+#include "spatial_grid.h"
+#include "enemy_store.h"
+#include "fixed_pool.h"
+#include "rng.h"
+#include "profiler.h"
+#include "job_system.h"
+#include "frame_arena.h"
+#include "modifier_stack.h"
+#include "flow_field.h"
+#include "fast_math.h"
+#include "swept_collision.h"
+#include "snapshot.h"
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <cstdio>
+
+// =====================================================
+// Headless gameplay simulation
+// Everything the PLAYING state needs lives here. Nothing in GameSim::Step
+// touches the window, the GL context or the audio device, so the same code
+// drives the game, load tests and CI runs without a GPU.
+// =====================================================
+
+enum class PowerUpType {
+    RAPID_FIRE,
+    SPREAD_SHOT,
+    DAMAGE_BOOST,
+    SPEED_BOOST,
+    SHIELD,
+    ROCKET_LAUNCHER,
+    HEALTH_PACK
+};
+
+enum class ProjectileType {
+    BULLET,
+    ROCKET
+};
+
+struct PowerUp {
+    PowerUpType type;
+    Vector2 position;
+    float radius;
+    float duration;
+    Color color;
+    PowerUp(PowerUpType t, Vector2 pos)
+        : type(t), position(pos), radius(18.f), duration(8.f), color(WHITE) {}
+};
+
+inline Color GetPowerUpColor(PowerUpType type) {
+    switch (type) {
+        case PowerUpType::RAPID_FIRE: return ORANGE;
+        case PowerUpType::SPREAD_SHOT: return (Color){120, 220, 120, 255};
+        case PowerUpType::DAMAGE_BOOST: return (Color){255, 80, 110, 255};
+        case PowerUpType::SPEED_BOOST: return (Color){90, 200, 255, 255};
+        case PowerUpType::SHIELD: return (Color){150, 240, 255, 255};
+        case PowerUpType::ROCKET_LAUNCHER: return (Color){255, 150, 60, 255};
+        case PowerUpType::HEALTH_PACK: return (Color){80, 230, 120, 255};
+        default: return WHITE;
+    }
+}
+
+inline const char* GetPowerUpLabel(PowerUpType type) {
+    switch (type) {
+        case PowerUpType::RAPID_FIRE: return "Rapid";
+        case PowerUpType::SPREAD_SHOT: return "Spread";
+        case PowerUpType::DAMAGE_BOOST: return "Damage";
+        case PowerUpType::SPEED_BOOST: return "Speed";
+        case PowerUpType::SHIELD: return "Shield";
+        case PowerUpType::ROCKET_LAUNCHER: return "Rocket";
+        case PowerUpType::HEALTH_PACK: return "Health";
+        default: return "??";
+    }
+}
+
+inline float GetPowerUpDuration(PowerUpType type) {
+    switch (type) {
+        case PowerUpType::RAPID_FIRE: return 8.f;
+        case PowerUpType::SPREAD_SHOT: return 10.f;
+        case PowerUpType::DAMAGE_BOOST: return 8.f;
+        case PowerUpType::SPEED_BOOST: return 6.f;
+        case PowerUpType::SHIELD: return 12.f;
+        case PowerUpType::ROCKET_LAUNCHER: return 12.f;
+        case PowerUpType::HEALTH_PACK: return 0.f;
+        default: return 8.f;
+    }
+}
+
+// A field pickup of `type`; size, lifetime and colour all follow from the type.
+inline PowerUp MakePowerUp(PowerUpType type, Vector2 position) {
+    PowerUp drop(type, position);
+    drop.duration = GetPowerUpDuration(type);
+    drop.color = GetPowerUpColor(type);
+    if (type == PowerUpType::SHIELD || type == PowerUpType::ROCKET_LAUNCHER) drop.radius = 20.f;
+    return drop;
+}
+
+inline Modifier GetPowerUpModifier(PowerUpType type) {
+    Modifier modifier;
+    switch (type) {
+        case PowerUpType::RAPID_FIRE: modifier.fireRateMultiplier = 1.75f; break;
+        case PowerUpType::SPREAD_SHOT: modifier.spreadLevel = 1; break;
+        case PowerUpType::DAMAGE_BOOST: modifier.damageMultiplier = 1.6f; break;
+        case PowerUpType::SPEED_BOOST: modifier.speedMultiplier = 1.35f; break;
+        case PowerUpType::SHIELD: modifier.shield = true; break;
+        case PowerUpType::ROCKET_LAUNCHER: modifier.rocketLauncher = true; break;
+        case PowerUpType::HEALTH_PACK: break;
+    }
+    return modifier;
+}
+
+//--------------------------------------------------------------------------------------------------------
+// =====================================================
+// Web-configurable globals (Daily Seed / Remote config)
+// Place near top-level, after your types/classes.
+// =====================================================
+
+// NEW: live values that the web request can override
+static float enemyCountMultiplier    = 1.0f;   // used in SpawnWave
+static float powerUpSpawnIntervalMin = 8.0f;   // used where you schedule powerups
+static float powerUpSpawnIntervalMax = 14.0f;
+static float enemyDropChance         = 0.22f;  // used in TryDropPowerUp()
+
+// NEW: starting wave overridden by the seed (read when you press PLAY)
+static int   startingWaveOverride    = 1;
+
+// Base seed for the game RNG (the daily seed's day number); each run mixes in its index.
+static uint64_t rngSeed              = 0;
+
+//--------------------------------------------------------------------------------------------------------
+// ---------------- Player ----------------
+class Player {
+public:
+    Vector2 position;
+    Vector2 previousPosition;  // start of the last step, for render interpolation
+    int health;
+    float speed;
+    float baseSpeed;
+    float radius;
+    int baseMaxHealth;
+    int maxHealth;
+    int shieldCharges;
+    float shieldTimer;
+
+    Player() {
+        position = {500.f, 500.f};
+        previousPosition = position;
+        baseMaxHealth = 100;
+        maxHealth = baseMaxHealth;
+        health = maxHealth;
+        baseSpeed = 300.f;
+        speed = baseSpeed;
+        radius = 20.f;
+        shieldCharges = 0;
+        shieldTimer = 0.f;
+    }
+
+    void ResetHealth() { health = maxHealth; }
+    void ResetPosition() {
+        position = {500.f, 500.f};
+        previousPosition = position;
+    }
+    void ResetStatus() {
+        speed = baseSpeed;
+        shieldCharges = 0;
+        shieldTimer = 0.f;
+    }
+    void SetMaxHealthMultiplier(float multiplier) {
+        if (multiplier < 1.f) multiplier = 1.f;
+        int oldMax = maxHealth;
+        int newMax = static_cast<int>(std::round(static_cast<float>(baseMaxHealth) * multiplier));
+        if (newMax < baseMaxHealth) newMax = baseMaxHealth;
+        if (newMax <= 0) newMax = baseMaxHealth;
+        float healthRatio = (oldMax > 0) ? static_cast<float>(health) / static_cast<float>(oldMax) : 1.f;
+        maxHealth = newMax;
+        int newHealth = static_cast<int>(std::round(healthRatio * static_cast<float>(maxHealth)));
+        if (newHealth < 0) newHealth = 0;
+        if (newHealth > maxHealth) newHealth = maxHealth;
+        health = newHealth;
+    }
+    void UpdateShield(float delta) {
+        if (shieldTimer > 0.f) {
+            shieldTimer -= delta;
+            if (shieldTimer <= 0.f) {
+                shieldTimer = 0.f;
+                shieldCharges = 0;
+            }
+        }
+    }
+
+    void Update(float delta, Vector2 inputDir, float boundsW, float boundsH) {
+        if (Vector2Length(inputDir) > 1.f) inputDir = Vector2Normalize(inputDir);
+        position = Vector2Add(position, Vector2Scale(inputDir, speed * delta));
+
+        if (position.x < radius) position.x = radius;
+        if (position.x > boundsW - radius) position.x = boundsW - radius;
+        if (position.y < radius) position.y = radius;
+        if (position.y > boundsH - radius) position.y = boundsH - radius;
+        UpdateShield(delta);
+    }
+
+    Vector2 InterpolatedPosition(float alpha) const { return Vector2Lerp(previousPosition, position, alpha); }
+
+    void Draw() const { Draw(position); }
+    void Draw(Vector2 at) const {
+        Color bodyColor = GREEN;
+        if (shieldCharges > 0) {
+            float pulse = 0.5f + 0.5f * FastSin(WrapPhase(GetTime() * 6.0));
+            Color shieldColor = {static_cast<unsigned char>(100 + 80 * pulse),
+                                 static_cast<unsigned char>(230),
+                                 static_cast<unsigned char>(255),
+                                 180};
+            DrawCircleV(at, radius + 8.f, Fade(shieldColor, 0.5f));
+            DrawRing(at, radius + 2.f, radius + 10.f, 0.f, 360.f, 32,
+                     {120, 240, 255, static_cast<unsigned char>(120 + 60 * pulse)});
+        }
+        DrawCircleV(at, radius, bodyColor);
+    }
+};
+
+// ---------------- Gun ----------------
+class Gun {
+public:
+    float distanceFromPlayer = 40.f;
+    float size = 20.f;
+
+    // Scales the aim vector instead of taking cos/sin of its angle. Aiming at the player's
+    // own centre points right, as atan2(0, 0) = 0 did.
+    Vector2 GetPosition(Vector2 playerPos, Vector2 aimPos) const {
+        float dx = aimPos.x - playerPos.x;
+        float dy = aimPos.y - playerPos.y;
+        float length = std::sqrt(dx * dx + dy * dy);
+        if (length <= 0.f) return {playerPos.x + distanceFromPlayer, playerPos.y};
+        float scale = distanceFromPlayer / length;
+        return {playerPos.x + dx * scale, playerPos.y + dy * scale};
+    }
+
+    float GetAngle(Vector2 playerPos, Vector2 aimPos) const {
+        return FastAtan2(aimPos.y - playerPos.y, aimPos.x - playerPos.x);
+    }
+
+    void Draw(Vector2 playerPos, Vector2 aimPos) const {
+        Vector2 gunPos = GetPosition(playerPos, aimPos);
+        float angle = GetAngle(playerPos, aimPos) * RAD2DEG;
+        Rectangle barrel = {playerPos.x, playerPos.y - 5.f, distanceFromPlayer + size, 10.f};
+        DrawRectanglePro(barrel, {0.f, 5.f}, angle, DARKGRAY);
+        DrawCircleV(gunPos, size * 0.6f, GRAY);
+    }
+};
+
+struct Explosion {
+    Vector2 position;
+    float radius;
+    float lifetime;
+    float elapsed;
+    int damage;
+    bool applied;
+};
+
+// ---------------- Bullet ----------------
+class Bullet {
+public:
+    ProjectileType type;
+    Vector2 position;
+    Vector2 previousPosition;  // start of the last step, for render interpolation
+    Vector2 velocity;
+    float radius;
+    int damage;
+    Color color;
+    float explosionRadius;
+    bool spent;  // consumed this frame; dropped by the end-of-frame compaction
+
+    Bullet() = default;
+    Bullet(Vector2 start, Vector2 vel, int dmg, Color tint,
+           ProjectileType projType = ProjectileType::BULLET, float explosion = 0.f) {
+        type = projType;
+        position = start;
+        previousPosition = start;
+        velocity = vel;
+        radius = 5.f;
+        damage = dmg;
+        color = tint;
+        explosionRadius = explosion;
+        spent = false;
+        if (type == ProjectileType::ROCKET) radius = 8.f;
+    }
+
+    void Update(float delta) {
+        previousPosition = position;
+        position.x += velocity.x * delta;
+        position.y += velocity.y * delta;
+    }
+
+    void Draw() { DrawCircleV(position, radius, color); }
+
+    bool IsOffScreen(float boundsW, float boundsH) {
+        return position.x < 0.f || position.x > boundsW ||
+               position.y < 0.f || position.y > boundsH;
+    }
+};
+
+// Drops flagged entries in one stable pass; survivors keep their relative order.
+template <typename T, typename IsDeadFn>
+inline void RemoveDead(std::vector<T>& items, IsDeadFn isDead) {
+    items.erase(std::remove_if(items.begin(), items.end(), isDead), items.end());
+}
+
+// ---------------- Simulation ----------------
+// Per-frame player intent, sampled by the caller (mouse, touch, keyboard, joystick).
+struct InputFrame {
+    Vector2 aim = {0.f, 0.f};   // world-space aim point (mouse or fire touch)
+    Vector2 move = {0.f, 0.f};  // combined joystick + keyboard direction
+    bool fire = false;
+};
+
+// What happened during one Step, so the front end can play sounds and switch states.
+struct SimEvents {
+    int shots = 0;
+    int enemyHits = 0;
+    int playerHits = 0;
+    int explosions = 0;
+    int pickups = 0;
+    bool gameOver = false;
+    bool waveCleared = false;
+
+    // Folds the events of another step into this frame's totals.
+    void Accumulate(const SimEvents& other) {
+        shots += other.shots;
+        enemyHits += other.enemyHits;
+        playerHits += other.playerHits;
+        explosions += other.explosions;
+        pickups += other.pickups;
+        gameOver = gameOver || other.gameOver;
+        waveCleared = waveCleared || other.waveCleared;
+    }
+};
+
+// Horde mode: waves far past the classic 45-enemy cap, for stress tests and endless play.
+// Nothing is placed up front; Step streams the wave in at most spawnPerStep enemies per
+// step while fewer than aliveCap are alive. A count budget rather than a time budget keeps
+// replays exact.
+struct HordeSettings {
+    static constexpr int maxAliveCap = 20000;  // also the largest cap a snapshot restores
+
+    bool enabled = false;
+    float countMultiplier = 100.f;  // times the classic wave size (8 + 3 per wave)
+    int spawnPerStep = 256;
+    int aliveCap = maxAliveCap;
+};
+
+class GameSim {
+public:
+    static constexpr float baseFireCooldown = 0.22f;
+    static constexpr int baseBulletDamage = 20;
+    static constexpr float baseBulletSpeed = 520.f;
+    static constexpr float baseRocketCooldown = 0.65f;
+    static constexpr int baseRocketDamage = 70;
+    static constexpr float baseRocketSpeed = 360.f;
+    static constexpr float rocketExplosionRadius = 110.f;
+    static constexpr int maxFieldPowerUps = 3;
+    static constexpr int healthPickupAmount = 30;
+    static constexpr float healthDropBias = 0.55f;
+    static constexpr float permanentUpgradePercent = 0.15f;
+    static constexpr float bulletGridCellSize = 48.f;
+    static constexpr float enemyGridCellSize = 64.f;
+    static constexpr float explosionKnockback = 90.f;
+    static constexpr int maxBullets = 1024;  // well above sustained rapid fire + spread on a large window
+    static constexpr int explosionReserve = 256;  // blasts live 0.35 s; a rocket storm peaks well below this
+    static constexpr size_t enemyMoveChunk = 2048;  // enemies per movement job; smaller waves stay on one thread
+    static constexpr size_t collisionChunk = 1024;  // enemies per narrow-phase job
+    static constexpr size_t parallelCollisionMinEnemies = 2 * collisionChunk;  // below this Step searches serially
+    // Break-even pool size for the gather: on one thread it runs at about 0.9x the serial
+    // search (BenchParallelCollision), so two cores already come out ahead.
+    static constexpr int parallelCollisionMinThreads = 2;
+    static constexpr int maxCollisionCandidates = 2;  // lowest-index bullets kept per enemy before falling back
+    static constexpr float flowCellSize = 32.f;
+    static constexpr int separationCellCap = 4;  // neighbours sampled per grid cell, so dense crowds stay O(n)
+    static constexpr float separationStiffness = 0.25f;  // share of an overlap each enemy resolves per step
+    static constexpr float separationMaxSpeed = 180.f;  // cap on how fast the crowd can shove one enemy (px/s)
+
+    float worldWidth = 1000.f;
+    float worldHeight = 1000.f;
+
+    Player player;
+    Gun gun;
+    EnemyStore enemies;
+    EnemyWaveStats enemyStats = ScaleEnemyArchetypes(1);  // archetypes scaled to the last spawned wave
+    FixedPool<Bullet> bullets;  // shots past capacity are dropped and counted
+    JobSystem* jobs = nullptr;  // optional workers for movement, separation and collisions; results match serial
+    FlowField flowField;  // enemy routing around walls; SetWorldSize clears the walls
+    bool crowdSeparation = true;  // SeparateEnemies every step; benches that time other phases turn it off
+    std::vector<PowerUp> powerUps;
+    ModifierStack powerUpEffects;  // timed pickups, keyed by PowerUpType
+    std::vector<Explosion> explosions;
+
+    int currentWave = 1;
+    int enemiesRemaining = 0;  // whole wave, including horde enemies not spawned yet
+    HordeSettings horde;
+    int pendingSpawns = 0;  // horde enemies of this wave still waiting for room
+    int pendingWave = 0;
+    bool gameOver = false;
+
+    float fireTimer = 0.f;
+    float powerUpSpawnTimer = 6.f;
+    float permanentHealthMultiplier = 1.f;
+    float permanentFireRateMultiplier = 1.f;
+    float permanentDamageMultiplier = 1.f;
+
+    GameRng rng;
+    uint64_t runsStarted = 0;
+
+    GameSim() {
+        player.SetMaxHealthMultiplier(permanentHealthMultiplier);
+        bullets.SetCapacity(maxBullets);
+        // Everything Step appends to is sized up front, so a steady frame never touches the heap.
+        powerUps.reserve(maxFieldPowerUps);
+        powerUpEffects.Reserve(static_cast<size_t>(PowerUpType::HEALTH_PACK));  // one per timed type
+        explosions.reserve(explosionReserve);
+        flowField.Reset(worldWidth, worldHeight, flowCellSize);
+    }
+
+    void SetWorldSize(float width, float height) {
+        if (width == worldWidth && height == worldHeight) return;
+        worldWidth = width;
+        worldHeight = height;
+        flowField.Reset(worldWidth, worldHeight, flowCellSize);
+    }
+
+    void ResetPermanentUpgrades();
+    // Reseeds the RNG from rngSeed and the run index, so a (day, run) pair replays exactly.
+    void StartRun();
+    // Starts a run from an explicit RNG seed (replays pass the recorded one).
+    void StartRun(uint64_t seed);
+    void SpawnWave(int wave);
+    void ApplyUpgrade(int option);
+    // Starts (or restarts) a timed effect without the pickup side effects; load tests use it.
+    void GrantPowerUp(PowerUpType type, float duration) {
+        powerUpEffects.Add(static_cast<int>(type), GetPowerUpModifier(type), duration);
+    }
+    SimEvents Step(const InputFrame& input, float delta);
+
+    // Bullet-vs-enemy hits are swept: a bullet hits if its last step (previousPosition to
+    // position) passed within reach, so nothing tunnels through an enemy at low tick rates
+    // or high speeds. BuildBulletGrid buckets each step by its midpoint and copies the steps
+    // into bulletSweeps in grid order; FindBulletHit returns the lowest-index live bullet
+    // whose step touched the circle, or -1.
+    void BuildBulletGrid();
+    int FindBulletHit(Vector2 position, float radius) const;
+
+    // Narrow phase for Step: player contacts and the lowest-index live bullets whose step
+    // touched each enemy, tested a grid cell at a time in SIMD batches. Each chunk of
+    // collisionChunk enemies gathers into its own buffer, and the buffers are joined in
+    // chunk order, so the keys come out in enemy order with no sort.
+    // Keys are (enemy << 32) | (bullet + 1): slot 0 means player contact and
+    // collisionOverflow means more bullets may overlap than were kept. An enemy's keys list
+    // its contact, or else its bullets by ascending index and then the overflow marker.
+    static constexpr uint64_t collisionOverflow = 0xFFFFFFFFull;
+    template <typename Keys>
+    void GatherCollisions(Keys& keys);
+    // Step gathers in parallel only when the roster spans several jobs on a pool of at
+    // least parallelCollisionMinThreads. Below that the gather costs more than the serial
+    // per-enemy search it replaces, and a single chunk gives nothing to split.
+    // Both paths resolve the same hits in the same order.
+    bool ParallelCollisions() const {
+        return jobs && jobs->ThreadCount() >= parallelCollisionMinThreads &&
+               enemies.Size() >= parallelCollisionMinEnemies;
+    }
+
+    // FNV-1a over the gameplay state (player, enemies, projectiles, pickups, wave, RNG
+    // counters). Two sims fed the same inputs must agree on this every step.
+    uint64_t StateChecksum() const;
+
+    // Packs the run state into `out` (format in snapshot.h), resizing it to fit. Reusing
+    // the same buffer keeps frame-by-frame snapshots off the heap once it has grown.
+    // Returns false, leaving `out` alone, for a world larger than snapshots can encode.
+    bool SaveSnapshot(std::vector<uint8_t>& out) const;
+    // Returns false, leaving the sim untouched, if the data is not a snapshot this build reads
+    // or its header holds values no run reaches.
+    // A snapshot from a different world size resizes the world, which clears flow-field walls.
+    bool RestoreSnapshot(const uint8_t* data, size_t size);
+
+    // Radius query over enemies. BuildEnemyGrid buckets the current positions;
+    // QueryEnemiesInRadius fills `hits` with the ascending indices of live enemies
+    // whose circle touches (center, radius). Knockback applied after the build is
+    // covered by enemyGridSlack, so results stay exact until the next rebuild.
+    void BuildEnemyGrid();
+    template <typename Hits>
+    void QueryEnemiesInRadius(Vector2 center, float radius, Hits& hits) const;
+
+    // Pushes overlapping enemies apart (rebuilds the enemy grid first). Each enemy looks
+    // at no more than separationCellCap neighbours per cell around it, so the pass is
+    // linear in the crowd size, and the result does not depend on the thread count.
+    void SeparateEnemies(float delta);
+
+    // Step's transient lists (collision keys, explosion hits) come from here; reset every step.
+    const FrameArena& Scratch() const { return scratch; }
+
+private:
+    SimEvents events;
+    SpatialGrid bulletGrid;
+    float maxBulletRadius = 0.f;
+    float maxBulletHalfStep = 0.f;  // widens bullet grid queries to cover steps bucketed by midpoint
+    ProjectileSweeps bulletSweeps;  // bullet steps in bulletGrid slot order
+    SpatialGrid enemyGrid;
+    float maxEnemyRadius = 0.f;
+    float enemyGridSlack = 0.f;  // furthest any enemy may have moved since BuildEnemyGrid
+    uint64_t appliedEffectsVersion = ~0ull;  // powerUpEffects.Rebuilds() when player.speed was last derived
+    std::vector<std::vector<uint64_t>> collisionBuffers;  // one per collisionChunk enemies, reused every step
+    FrameArena scratch;
+
+    void FindCollisions(size_t begin, size_t end, std::vector<uint64_t>& keys) const;
+    void FindSeparation(size_t begin, size_t end, float maxPush, float* pushX, float* pushY) const;
+    void ReserveScratch(size_t roster);
+    void ReserveCollisionBuffers(size_t enemyCount);
+    void SpawnEnemy();
+    void StreamSpawns();
+    void KillEnemy(size_t index);
+    void ResolveContact(size_t i);
+    void ResolveBulletHit(size_t i, int j);
+
+    float RollPowerUpSpawnInterval();
+    void ApplyPowerStats(const PowerStats& stats);
+    void ActivatePowerUp(PowerUpType type);
+    void CreatePowerUpInstance(PowerUpType type, Vector2 position);
+    void SpawnRandomPowerUp(Vector2 position, RngStream& stream);
+    void TryDropPowerUp(Vector2 position);
+    void SpawnExplosion(Vector2 position, float radius, int damage);
+    void FireWeapon(const PowerStats& stats, Vector2 aim);
+};
+
+inline void GameSim::ResetPermanentUpgrades() {
+    permanentHealthMultiplier = 1.f;
+    permanentFireRateMultiplier = 1.f;
+    permanentDamageMultiplier = 1.f;
+    player.SetMaxHealthMultiplier(permanentHealthMultiplier);
+    player.ResetHealth();
+}
+
+inline void GameSim::StartRun() {
+    uint64_t seed = SplitMix64(rngSeed) ^ runsStarted;
+    runsStarted++;
+    StartRun(seed);
+}
+
+inline void GameSim::StartRun(uint64_t seed) {
+    rng.Seed(seed);
+    ResetPermanentUpgrades();
+    pendingWave = 0;
+    currentWave = startingWaveOverride; // CHANGED: daily seed decides 1..3
+    SpawnWave(currentWave);
+    gameOver = false;
+}
+
+inline float GameSim::RollPowerUpSpawnInterval() {
+    return static_cast<float>(rng.fieldPowerUps.Range(
+               static_cast<int>(powerUpSpawnIntervalMin * 10.f),
+               static_cast<int>(powerUpSpawnIntervalMax * 10.f))) /
+           10.f;
+}
+
+inline void GameSim::SpawnWave(int wave) {
+    enemies.Clear();
+    bullets.Clear();
+    powerUps.clear();
+    powerUpEffects.Clear();
+    explosions.clear();
+    player.SetMaxHealthMultiplier(permanentHealthMultiplier);
+    if (wave == 1) {
+        player.ResetHealth();
+        player.ResetPosition();
+    }
+    player.ResetStatus();
+    player.previousPosition = player.position;
+    fireTimer = 0.f;
+    powerUpSpawnTimer = RollPowerUpSpawnInterval();
+
+    int baseCount = 8 + (wave - 1) * 3;
+    float multiplier = enemyCountMultiplier * (horde.enabled ? horde.countMultiplier : 1.f);
+    int count = static_cast<int>(std::lround(baseCount * multiplier)); // CHANGED: use live multiplier
+    if (count < 1) count = 1;
+    if (!horde.enabled && count > 45) count = 45;
+
+    enemyStats = ScaleEnemyArchetypes(wave);
+    enemiesRemaining = count;
+    if (horde.enabled) {
+        // Streamed by Step; storage is sized for the most that can be alive at once.
+        pendingSpawns = count;
+        size_t roster = static_cast<size_t>(std::min(count, std::max(horde.aliveCap, 1)));
+        enemies.Reserve(roster);
+        ReserveScratch(roster);
+        return;
+    }
+    pendingSpawns = 0;
+    for (int i = 0; i < count; i++) SpawnEnemy();
+    ReserveScratch(enemies.Size());
+}
+
+// One enemy of the wave in enemyStats, at a random edge outside the player's safe radius.
+inline void GameSim::SpawnEnemy() {
+    const float safeRadius = 180.f;
+    int screenW = static_cast<int>(worldWidth);
+    int screenH = static_cast<int>(worldHeight);
+    // Weighted bag as one fixed table; later waves unlock a longer prefix.
+    static const EnemyType typeBag[] = {
+        EnemyType::GRUNT, EnemyType::GRUNT, EnemyType::GRUNT, EnemyType::RUNNER, EnemyType::RUNNER, EnemyType::TANK
+    };
+    int wave = enemyStats.wave;
+
+    Vector2 spawn = {0.f, 0.f};
+    int side = rng.waveSpawn.Range(0, 3);
+    switch (side) {
+        case 0: // Left
+            spawn = {-60.f, static_cast<float>(rng.waveSpawn.Range(0, screenH))};
+            break;
+        case 1: // Right
+            spawn = {worldWidth + 60.f,
+                     static_cast<float>(rng.waveSpawn.Range(0, screenH))};
+            break;
+        case 2: // Top
+            spawn = {static_cast<float>(rng.waveSpawn.Range(0, screenW)),
+                     -60.f};
+            break;
+        case 3: // Bottom
+        default:
+            spawn = {static_cast<float>(rng.waveSpawn.Range(0, screenW)),
+                     worldHeight + 60.f};
+            break;
+    }
+
+    Vector2 toPlayer = {player.position.x - spawn.x, player.position.y - spawn.y};
+    float distance = sqrtf(toPlayer.x * toPlayer.x + toPlayer.y * toPlayer.y);
+    if (distance < safeRadius) {
+        Vector2 dir;
+        if (distance == 0.f) {
+            dir = {1.f, 0.f};
+        } else {
+            dir = {toPlayer.x / distance, toPlayer.y / distance};
+        }
+        spawn.x -= dir.x * (safeRadius - distance);
+        spawn.y -= dir.y * (safeRadius - distance);
+    }
+    int bagSize = wave >= 4 ? 6 : (wave >= 2 ? 5 : 3);
+    EnemyType type = typeBag[rng.waveSpawn.Range(0, bagSize - 1)];
+    float phase = static_cast<float>(rng.enemyTraits.Range(0, 360)) * DEG2RAD;
+    enemies.Push(Enemy(spawn, type, enemyStats, phase));
+}
+
+inline void GameSim::StreamSpawns() {
+    if (pendingSpawns <= 0) return;
+    int room = horde.aliveCap - static_cast<int>(enemies.Size());
+    int batch = std::min(pendingSpawns, std::min(horde.spawnPerStep, room));
+    for (int i = 0; i < batch; i++) SpawnEnemy();
+    if (batch > 0) pendingSpawns -= batch;
+}
+
+// A classic wave only shrinks once spawned and a horde never exceeds its alive cap, so sizing
+// the per-step scratch for that roster (and the bullet pool's capacity) keeps every
+// following step off the heap.
+inline void GameSim::ReserveScratch(size_t roster) {
+    size_t enemyCount = roster;
+    bulletGrid.Reset(0.f, 0.f, worldWidth, worldHeight, bulletGridCellSize);
+    bulletGrid.Reserve(static_cast<int>(bullets.Capacity()));
+    bulletSweeps.Reserve(bullets.Capacity());
+    enemyGrid.Reset(0.f, 0.f, worldWidth, worldHeight, enemyGridCellSize);
+    enemyGrid.Reserve(static_cast<int>(enemyCount));
+    size_t keys = enemyCount * (maxCollisionCandidates + 1);
+    // Merged collision keys, flow-field targets, separation pushes and one explosion hit list,
+    // with room for alignment padding.
+    scratch.Reserve(keys * sizeof(uint64_t) + enemyCount * (4 * sizeof(float) + sizeof(int)) + 256);
+    ReserveCollisionBuffers(enemyCount);
+}
+
+// A chunk never yields more than maxCollisionCandidates + 1 keys per enemy, so reserving
+// that up front means no buffer grows during a parallel gather.
+inline void GameSim::ReserveCollisionBuffers(size_t enemyCount) {
+    size_t chunks = (enemyCount + collisionChunk - 1) / collisionChunk;
+    if (collisionBuffers.size() < chunks) collisionBuffers.resize(chunks);
+    for (auto &buffer : collisionBuffers) buffer.reserve(collisionChunk * (maxCollisionCandidates + 1));
+}
+
+inline void GameSim::ApplyUpgrade(int option) {
+    switch (option) {
+        case 0: // Health
+            permanentHealthMultiplier *= (1.f + permanentUpgradePercent);
+            player.SetMaxHealthMultiplier(permanentHealthMultiplier);
+            break;
+        case 1: // Fire rate
+            permanentFireRateMultiplier *= (1.f + permanentUpgradePercent);
+            break;
+        case 2: // Damage
+            permanentDamageMultiplier *= (1.f + permanentUpgradePercent);
+            break;
+    }
+    fireTimer = 0.f;
+    if (pendingWave <= currentWave) pendingWave = currentWave + 1;
+    currentWave = pendingWave;
+    pendingWave = 0;
+    SpawnWave(currentWave);
+}
+
+inline void GameSim::ActivatePowerUp(PowerUpType type) {
+    events.pickups++;
+    if (type == PowerUpType::HEALTH_PACK) {
+        if (player.health < player.maxHealth) {
+            player.health = std::min(player.maxHealth, player.health + healthPickupAmount);
+        }
+        return;
+    }
+
+    float duration = GetPowerUpDuration(type);
+    GrantPowerUp(type, duration);
+
+    switch (type) {
+        case PowerUpType::RAPID_FIRE:
+        case PowerUpType::SPREAD_SHOT:
+        case PowerUpType::DAMAGE_BOOST:
+        case PowerUpType::SPEED_BOOST:
+            break;
+        case PowerUpType::SHIELD:
+            player.shieldCharges = std::min(player.shieldCharges + 2, 4);
+            player.shieldTimer = duration;
+            break;
+        case PowerUpType::ROCKET_LAUNCHER:
+            fireTimer = 0.f;
+            break;
+        default:
+            break;
+    }
+}
+
+// Only called when the effect set changed; the shield timer is synced every step in Step.
+inline void GameSim::ApplyPowerStats(const PowerStats& stats) {
+    player.speed = player.baseSpeed * stats.speedMultiplier;
+    if (player.speed < player.baseSpeed * 0.6f) player.speed = player.baseSpeed * 0.6f;
+    if (player.speed > player.baseSpeed * 2.2f) player.speed = player.baseSpeed * 2.2f;
+}
+
+inline void GameSim::CreatePowerUpInstance(PowerUpType type, Vector2 position) {
+    PowerUp drop = MakePowerUp(type, position);
+    drop.position.x = std::max(drop.radius, std::min(drop.position.x, worldWidth - drop.radius));
+    drop.position.y = std::max(drop.radius, std::min(drop.position.y, worldHeight - drop.radius));
+    powerUps.push_back(drop);
+}
+
+inline void GameSim::SpawnRandomPowerUp(Vector2 position, RngStream& stream) {
+    if ((int)powerUps.size() >= maxFieldPowerUps) return;
+    static const PowerUpType bag[] = {
+        PowerUpType::RAPID_FIRE,
+        PowerUpType::SPREAD_SHOT,
+        PowerUpType::DAMAGE_BOOST,
+        PowerUpType::SPEED_BOOST,
+        PowerUpType::SHIELD,          // from wave 2
+        PowerUpType::ROCKET_LAUNCHER  // from wave 3
+    };
+    int bagSize = currentWave >= 3 ? 6 : (currentWave >= 2 ? 5 : 4);
+    PowerUpType type = bag[stream.Range(0, bagSize - 1)];
+    CreatePowerUpInstance(type, position);
+}
+
+inline void GameSim::TryDropPowerUp(Vector2 position) {
+    if ((int)powerUps.size() >= maxFieldPowerUps) return;
+    int roll = rng.drops.Range(0, 999);
+    if (roll < static_cast<int>(enemyDropChance * 1000.f)) {
+        bool droppedHealth = false;
+        if (player.health < player.maxHealth) {
+            float missingRatio = 1.f - static_cast<float>(player.health) / static_cast<float>(player.maxHealth);
+            float adjustedChance = healthDropBias + missingRatio * 0.35f;
+            if (adjustedChance > 0.95f) adjustedChance = 0.95f;
+            if (adjustedChance < 0.f) adjustedChance = 0.f;
+            int healthRoll = rng.drops.Range(0, 999);
+            if (healthRoll < static_cast<int>(adjustedChance * 1000.f)) {
+                CreatePowerUpInstance(PowerUpType::HEALTH_PACK, position);
+                droppedHealth = true;
+            }
+        }
+        if (!droppedHealth) {
+            SpawnRandomPowerUp(position, rng.drops);
+        }
+    }
+}
+
+inline void GameSim::SpawnExplosion(Vector2 position, float radius, int damage) {
+    Explosion ex{position, radius, 0.35f, 0.f, damage, false};
+    explosions.push_back(ex);
+    events.explosions++;
+}
+
+inline void GameSim::FireWeapon(const PowerStats& stats, Vector2 aim) {
+    float combinedFireRateMultiplier = stats.fireRateMultiplier * permanentFireRateMultiplier;
+    if (combinedFireRateMultiplier < 0.1f) combinedFireRateMultiplier = 0.1f;
+    float effectiveCooldown = (stats.rocketLauncher ? baseRocketCooldown : baseFireCooldown) / combinedFireRateMultiplier;
+    if (effectiveCooldown < 0.05f) effectiveCooldown = 0.05f;
+
+    Vector2 origin = gun.GetPosition(player.position, aim);
+    Vector2 target = aim;
+    Vector2 direction = Vector2Normalize(Vector2Subtract(target, origin));
+    if (Vector2Length(direction) <= 0.001f) direction = {1.f, 0.f};
+    bool rocket = stats.rocketLauncher;
+    float combinedDamageMultiplier = stats.damageMultiplier * permanentDamageMultiplier;
+    int projectileDamage = rocket
+        ? std::max(1, static_cast<int>(std::round(baseRocketDamage * combinedDamageMultiplier)))
+        : std::max(1, static_cast<int>(std::round(baseBulletDamage * combinedDamageMultiplier)));
+    float projectileSpeed = rocket
+        ? baseRocketSpeed * (combinedFireRateMultiplier > 1.f ? 1.f + (combinedFireRateMultiplier - 1.f) * 0.2f : 1.f)
+        : baseBulletSpeed * (combinedFireRateMultiplier > 1.f ? 1.f + (combinedFireRateMultiplier - 1.f) * 0.25f : 1.f);
+    Color bulletColor;
+    if (rocket) {
+        bulletColor = (Color){255, 130, 60, 255};
+    } else if (stats.spreadLevel > 0) {
+        bulletColor = (Color){255, 220, 140, 255};
+    } else {
+        bulletColor = combinedDamageMultiplier > 1.01f ? ORANGE : YELLOW;
+    }
+
+    // The spread offsets (0, +0.18, -0.18 rad) are fixed, so each shot is the aim vector
+    // turned by a precomputed unit rotation rather than an atan2 and a cos/sin per bullet.
+    static const UnitRotation spreadRotations[] = {{1.f, 0.f}, MakeUnitRotation(0.18f), MakeUnitRotation(-0.18f)};
+    int shotCount = (!rocket && stats.spreadLevel > 0) ? 3 : 1;
+
+    for (int s = 0; s < shotCount; s++) {
+        Vector2 velocity = Vector2Scale(Rotate(direction, spreadRotations[s]), projectileSpeed);
+        bullets.Push(Bullet(origin, velocity, projectileDamage, bulletColor,
+                            rocket ? ProjectileType::ROCKET : ProjectileType::BULLET,
+                            rocket ? rocketExplosionRadius : 0.f));
+    }
+    events.shots++;
+    fireTimer = effectiveCooldown;
+}
+
+inline void GameSim::BuildBulletGrid() {
+    bulletGrid.Reset(0.f, 0.f, worldWidth, worldHeight, bulletGridCellSize);
+    bulletGrid.Build(static_cast<int>(bullets.Size()), [&](int i) {
+        return Vector2Lerp(bullets[i].previousPosition, bullets[i].position, 0.5f);
+    });
+    maxBulletRadius = 0.f;
+    maxBulletHalfStep = 0.f;
+    for (auto &bullet : bullets) {
+        maxBulletRadius = std::max(maxBulletRadius, bullet.radius);
+        maxBulletHalfStep = std::max(maxBulletHalfStep, 0.5f * Vector2Distance(bullet.previousPosition, bullet.position));
+    }
+    bulletSweeps.Resize(bullets.Size());
+    for (size_t k = 0; k < bullets.Size(); k++) {
+        const Bullet& bullet = bullets[static_cast<size_t>(bulletGrid.ItemAt(static_cast<int>(k)))];
+        bulletSweeps.Set(k, bullet.previousPosition, bullet.position, bullet.radius);
+    }
+}
+
+inline int GameSim::FindBulletHit(Vector2 position, float radius) const {
+    float reach = radius + maxBulletRadius + maxBulletHalfStep;
+    int best = -1;
+    bulletGrid.QueryRanges(position.x - reach, position.y - reach,
+                           position.x + reach, position.y + reach, [&](int begin, int end) {
+        for (int k = begin; k < end; k++) {
+            int j = bulletGrid.ItemAt(k);
+            if (bullets[j].spent || (best >= 0 && j >= best)) continue;
+            if (bulletSweeps.Hit(static_cast<size_t>(k), position, radius)) best = j;
+        }
+    });
+    return best;
+}
+
+inline void GameSim::FindCollisions(size_t begin, size_t end, std::vector<uint64_t>& keys) const {
+    for (size_t i = begin; i < end; i++) {
+        Vector2 enemyPos = enemies.Position(i);
+        float enemyRadius = enemies.radius[i];
+        uint64_t enemyKey = static_cast<uint64_t>(i) << 32;
+        // Contact kills the enemy before any bullet can reach it, so its bullets are irrelevant.
+        if (CheckCollisionCircles(player.position, player.radius, enemyPos, enemyRadius)) {
+            keys.push_back(enemyKey);
+            continue;
+        }
+        // Keep the few lowest indices (ascending insertion); a dense pile-up only sets the overflow flag.
+        int candidates[maxCollisionCandidates];
+        int count = 0;
+        bool overflow = false;
+        float reach = enemyRadius + maxBulletRadius + maxBulletHalfStep;
+        auto keep = [&](int j) {
+            if (bullets[j].spent) return;
+            if (count == maxCollisionCandidates) {
+                overflow = true;
+                if (j > candidates[count - 1]) return;
+                count--;
+            }
+            int slot = count++;
+            while (slot > 0 && candidates[slot - 1] > j) {
+                candidates[slot] = candidates[slot - 1];
+                slot--;
+            }
+            candidates[slot] = j;
+        };
+        bulletGrid.QueryRanges(enemyPos.x - reach, enemyPos.y - reach, enemyPos.x + reach, enemyPos.y + reach,
+                               [&](int begin, int end) {
+            bulletSweeps.ForEachHit(static_cast<size_t>(begin), static_cast<size_t>(end - begin), enemyPos, enemyRadius,
+                                    [&](size_t k) { keep(bulletGrid.ItemAt(static_cast<int>(k))); });
+        });
+        for (int c = 0; c < count; c++) keys.push_back(enemyKey | static_cast<uint64_t>(candidates[c] + 1));
+        if (overflow) keys.push_back(enemyKey | collisionOverflow);
+    }
+}
+
+template <typename Keys>
+inline void GameSim::GatherCollisions(Keys& keys) {
+    size_t chunks = (enemies.Size() + collisionChunk - 1) / collisionChunk;
+    ReserveCollisionBuffers(enemies.Size());
+    // ParallelFor runs a small or single-thread range as one call, so split it here too.
+    auto findChunk = [this](size_t begin, size_t end) {
+        for (size_t chunkBegin = begin; chunkBegin < end; chunkBegin += collisionChunk) {
+            std::vector<uint64_t>& buffer = collisionBuffers[chunkBegin / collisionChunk];
+            buffer.clear();
+            FindCollisions(chunkBegin, std::min(chunkBegin + collisionChunk, end), buffer);
+        }
+    };
+    if (jobs) jobs->ParallelFor(0, enemies.Size(), collisionChunk, findChunk);
+    else findChunk(0, enemies.Size());
+
+    size_t total = 0;
+    for (size_t c = 0; c < chunks; c++) total += collisionBuffers[c].size();
+    keys.clear();
+    keys.reserve(total);  // one block, so an arena-backed list never leaves grown-out copies behind
+    for (size_t c = 0; c < chunks; c++) keys.insert(keys.end(), collisionBuffers[c].begin(), collisionBuffers[c].end());
+}
+
+inline void GameSim::BuildEnemyGrid() {
+    enemyGrid.Reset(0.f, 0.f, worldWidth, worldHeight, enemyGridCellSize);
+    enemyGrid.Build(static_cast<int>(enemies.Size()), [&](int i) { return enemies.Position(i); });
+    maxEnemyRadius = 0.f;
+    for (float r : enemies.radius) maxEnemyRadius = std::max(maxEnemyRadius, r);
+    enemyGridSlack = 0.f;
+}
+
+// Each overlapping pair pushes both enemies apart along the line between them, by a
+// share of the overlap; an exactly stacked pair splits along x by index.
+inline void GameSim::FindSeparation(size_t begin, size_t end, float maxPush, float* pushX, float* pushY) const {
+    for (size_t i = begin; i < end; i++) {
+        float x = enemies.posX[i];
+        float y = enemies.posY[i];
+        float radius = enemies.radius[i];
+        float sumX = 0.f, sumY = 0.f;
+        float reach = radius + maxEnemyRadius;
+        unsigned rotation = static_cast<unsigned>(i);  // each enemy samples a different slice of a crowded cell
+        enemyGrid.QueryCapped(x - reach, y - reach, x + reach, y + reach, separationCellCap, rotation, [&](int j) {
+            size_t other = static_cast<size_t>(j);
+            if (other == i) return;
+            float dx = x - enemies.posX[other];
+            float dy = y - enemies.posY[other];
+            float minDistance = radius + enemies.radius[other];
+            float distanceSq = dx * dx + dy * dy;
+            if (distanceSq >= minDistance * minDistance) return;
+            float distance = std::sqrt(distanceSq);
+            if (distance < 0.001f) {
+                dx = other < i ? 1.f : -1.f;
+                dy = 0.f;
+                distance = 1.f;
+            }
+            float share = (minDistance - distance) * separationStiffness / distance;
+            sumX += dx * share;
+            sumY += dy * share;
+        });
+        float lengthSq = sumX * sumX + sumY * sumY;
+        if (lengthSq > maxPush * maxPush) {
+            float scale = maxPush / std::sqrt(lengthSq);
+            sumX *= scale;
+            sumY *= scale;
+        }
+        pushX[i] = sumX;
+        pushY[i] = sumY;
+    }
+}
+
+inline void GameSim::SeparateEnemies(float delta) {
+    if (enemies.Size() < 2) return;
+    BuildEnemyGrid();
+    // Every push is computed from the same positions before any is applied, so the chunks
+    // only write their own slots.
+    ArenaVector<float> pushX{ArenaAllocator<float>(scratch)};
+    ArenaVector<float> pushY{ArenaAllocator<float>(scratch)};
+    pushX.resize(enemies.Size());
+    pushY.resize(enemies.Size());
+    float maxPush = separationMaxSpeed * delta;
+    auto separateChunk = [this, maxPush, &pushX, &pushY](size_t begin, size_t end) {
+        FindSeparation(begin, end, maxPush, pushX.data(), pushY.data());
+    };
+    if (jobs) jobs->ParallelFor(0, enemies.Size(), enemyMoveChunk, separateChunk);
+    else separateChunk(0, enemies.Size());
+    bool walls = flowField.HasWalls();
+    for (size_t i = 0; i < enemies.Size(); i++) {
+        Vector2 moved = {enemies.posX[i] + pushX[i], enemies.posY[i] + pushY[i]};
+        if (walls && flowField.Blocked(moved)) continue;  // the crowd never shoves anyone into a wall
+        enemies.posX[i] = moved.x;
+        enemies.posY[i] = moved.y;
+    }
+}
+
+template <typename Hits>
+inline void GameSim::QueryEnemiesInRadius(Vector2 center, float radius, Hits& hits) const {
+    hits.clear();
+    float reach = radius + maxEnemyRadius + enemyGridSlack;
+    enemyGrid.Query(center.x - reach, center.y - reach, center.x + reach, center.y + reach, [&](int i) {
+        if (enemies.dead[i]) return;
+        if (Vector2Distance(center, enemies.Position(i)) <= radius + enemies.radius[i]) hits.push_back(i);
+    });
+    // Cells hand back candidates grouped by cell; index order keeps damage and drop rolls deterministic.
+    std::sort(hits.begin(), hits.end());
+}
+
+inline uint64_t GameSim::StateChecksum() const {
+    uint64_t h = 1469598103934665603ull;
+    auto mix = [&h](const void* data, size_t bytes) {
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < bytes; i++) h = (h ^ p[i]) * 1099511628211ull;
+    };
+    mix(&player.position, sizeof(Vector2));
+    mix(&player.health, sizeof(int));
+    mix(&player.shieldCharges, sizeof(int));
+    size_t n = enemies.Size();
+    mix(enemies.posX.data(), n * sizeof(float));
+    mix(enemies.posY.data(), n * sizeof(float));
+    mix(enemies.timer.data(), n * sizeof(float));
+    mix(enemies.health.data(), n * sizeof(int));
+    for (const Bullet& bullet : bullets) {
+        mix(&bullet.position, sizeof(Vector2));
+        mix(&bullet.damage, sizeof(int));
+    }
+    for (const PowerUp& powerUp : powerUps) {
+        mix(&powerUp.type, sizeof(PowerUpType));
+        mix(&powerUp.position, sizeof(Vector2));
+    }
+    for (const ModifierStack::Effect& effect : powerUpEffects.Effects()) {
+        float remaining = powerUpEffects.Remaining(effect);
+        mix(&effect.key, sizeof(int));
+        mix(&remaining, sizeof(float));
+    }
+    mix(&currentWave, sizeof(int));
+    mix(&enemiesRemaining, sizeof(int));
+    // Classic waves never stream, so their checksums don't change with horde support.
+    if (horde.enabled) mix(&pendingSpawns, sizeof(int));
+    mix(&fireTimer, sizeof(float));
+    uint64_t counters[4] = {rng.waveSpawn.Counter(), rng.enemyTraits.Counter(),
+                            rng.drops.Counter(), rng.fieldPowerUps.Counter()};
+    mix(counters, sizeof(counters));
+    return h;
+}
+
+inline bool GameSim::SaveSnapshot(std::vector<uint8_t>& out) const {
+    // RestoreSnapshot rejects these, so a blob written from them could never be read back.
+    if (!(worldWidth <= snapshotMaxCoord && worldHeight <= snapshotMaxCoord)) return false;
+    const std::vector<ModifierStack::Effect>& effects = powerUpEffects.Effects();
+    out.resize(snapshotHeaderBytes + enemies.Size() * snapshotEnemyBytes + bullets.Size() * snapshotBulletBytes +
+               powerUps.size() * snapshotPowerUpBytes + explosions.size() * snapshotExplosionBytes +
+               effects.size() * snapshotEffectBytes);
+    SnapshotWriter writer(out.data());
+    const char magic[4] = {'W', 'B', 'S', 'S'};
+    for (char c : magic) writer.PutU8(static_cast<uint8_t>(c));
+    writer.PutU16(snapshotVersion);
+    writer.PutFloat(worldWidth);
+    writer.PutFloat(worldHeight);
+
+    writer.PutFloat(player.position.x);
+    writer.PutFloat(player.position.y);
+    writer.PutI32(player.health);
+    writer.PutFloat(player.speed);
+    writer.PutFloat(player.baseSpeed);
+    writer.PutFloat(player.radius);
+    writer.PutI32(player.baseMaxHealth);
+    writer.PutI32(player.maxHealth);
+    writer.PutI32(player.shieldCharges);
+    writer.PutFloat(player.shieldTimer);
+
+    writer.PutI32(currentWave);
+    writer.PutI32(enemiesRemaining);
+    writer.PutI32(pendingSpawns);
+    writer.PutI32(pendingWave);
+    writer.PutU8(gameOver ? 1 : 0);
+    writer.PutFloat(fireTimer);
+    writer.PutFloat(powerUpSpawnTimer);
+    writer.PutFloat(permanentHealthMultiplier);
+    writer.PutFloat(permanentFireRateMultiplier);
+    writer.PutFloat(permanentDamageMultiplier);
+    writer.PutU8(horde.enabled ? 1 : 0);
+    writer.PutFloat(horde.countMultiplier);
+    writer.PutI32(horde.spawnPerStep);
+    writer.PutI32(horde.aliveCap);
+    writer.PutU64(rng.SeedValue());
+    writer.PutU64(rng.waveSpawn.Counter());
+    writer.PutU64(rng.enemyTraits.Counter());
+    writer.PutU64(rng.drops.Counter());
+    writer.PutU64(rng.fieldPowerUps.Counter());
+    writer.PutU64(runsStarted);
+    writer.PutI32(enemyStats.wave);
+
+    writer.PutU32(static_cast<uint32_t>(enemies.Size()));
+    writer.PutU32(static_cast<uint32_t>(bullets.Size()));
+    writer.PutU32(static_cast<uint32_t>(powerUps.size()));
+    writer.PutU32(static_cast<uint32_t>(explosions.size()));
+    writer.PutU32(static_cast<uint32_t>(effects.size()));
+
+    const float timerScale = 65536.f / kEnemyTimerPeriod;
+    for (size_t i = 0; i < enemies.Size(); i++) {
+        writer.PutU8(enemies.type[i]);
+        writer.PutU8(static_cast<uint8_t>(QuantizeClamped(enemies.flashTimer[i] * 1000.f, 0.f, 255.f)));
+        writer.PutCoord(enemies.posX[i]);
+        writer.PutCoord(enemies.posY[i]);
+        writer.PutU8(static_cast<uint8_t>(QuantizeClamped(enemies.facingX[i] * 127.f, -127.f, 127.f)));
+        writer.PutU8(static_cast<uint8_t>(QuantizeClamped(enemies.facingY[i] * 127.f, -127.f, 127.f)));
+        writer.PutU16(static_cast<uint16_t>(QuantizeClamped(enemies.timer[i] * timerScale, 0.f, 65535.f)));
+        writer.PutU16(static_cast<uint16_t>(std::min(std::max(enemies.health[i], 0), 65535)));
+    }
+    for (const Bullet& bullet : bullets) {
+        writer.PutU8(static_cast<uint8_t>(bullet.type));
+        writer.PutCoord(bullet.position.x);
+        writer.PutCoord(bullet.position.y);
+        writer.PutFloat(bullet.velocity.x);
+        writer.PutFloat(bullet.velocity.y);
+        writer.PutI32(bullet.damage);
+        writer.PutU8(bullet.color.r);
+        writer.PutU8(bullet.color.g);
+        writer.PutU8(bullet.color.b);
+        writer.PutU8(bullet.color.a);
+        writer.PutFloat(bullet.explosionRadius);
+    }
+    for (const PowerUp& powerUp : powerUps) {
+        writer.PutU8(static_cast<uint8_t>(powerUp.type));
+        writer.PutCoord(powerUp.position.x);
+        writer.PutCoord(powerUp.position.y);
+    }
+    for (const Explosion& explosion : explosions) {
+        writer.PutCoord(explosion.position.x);
+        writer.PutCoord(explosion.position.y);
+        writer.PutFloat(explosion.radius);
+        writer.PutFloat(explosion.lifetime);
+        writer.PutFloat(explosion.elapsed);
+        writer.PutI32(explosion.damage);
+        writer.PutU8(explosion.applied ? 1 : 0);
+    }
+    for (const ModifierStack::Effect& effect : effects) {
+        writer.PutU8(static_cast<uint8_t>(effect.key));
+        writer.PutFloat(powerUpEffects.Remaining(effect));
+    }
+    return true;
+}
+
+inline bool GameSim::RestoreSnapshot(const uint8_t* data, size_t size) {
+    if (size < snapshotHeaderBytes || memcmp(data, "WBSS", 4) != 0) return false;
+    SnapshotReader reader(data + 4);
+    if (reader.GetU16() != snapshotVersion) return false;
+    float width = reader.GetFloat();
+    float height = reader.GetFloat();
+    // Written this way round so NaN fails too; anything past the q16 range could not
+    // hold the saved positions, and would size the flow field from garbage.
+    if (!(width > 0.f && width <= snapshotMaxCoord && height > 0.f && height <= snapshotMaxCoord)) return false;
+
+    // The run-wide values go into locals first and are checked like the world size: they
+    // feed the roster reservation, the health ratio and the HUD, so a bad header must not
+    // reach them.
+    Player saved;
+    saved.position.x = reader.GetFloat();
+    saved.position.y = reader.GetFloat();
+    saved.previousPosition = saved.position;
+    saved.health = reader.GetI32();
+    saved.speed = reader.GetFloat();
+    saved.baseSpeed = reader.GetFloat();
+    saved.radius = reader.GetFloat();
+    saved.baseMaxHealth = reader.GetI32();
+    saved.maxHealth = reader.GetI32();
+    saved.shieldCharges = reader.GetI32();
+    saved.shieldTimer = reader.GetFloat();
+    int savedWave = reader.GetI32();
+    int savedRemaining = reader.GetI32();
+    int savedPendingSpawns = reader.GetI32();
+    int savedPendingWave = reader.GetI32();
+    bool savedGameOver = reader.GetU8() != 0;
+    float savedFireTimer = reader.GetFloat();
+    float savedPowerUpSpawnTimer = reader.GetFloat();
+    float savedHealthMultiplier = reader.GetFloat();
+    float savedFireRateMultiplier = reader.GetFloat();
+    float savedDamageMultiplier = reader.GetFloat();
+    HordeSettings savedHorde;
+    savedHorde.enabled = reader.GetU8() != 0;
+    savedHorde.countMultiplier = reader.GetFloat();
+    savedHorde.spawnPerStep = reader.GetI32();
+    savedHorde.aliveCap = reader.GetI32();
+    uint64_t savedSeed = reader.GetU64();
+    uint64_t savedCounters[4] = {reader.GetU64(), reader.GetU64(), reader.GetU64(), reader.GetU64()};
+    uint64_t savedRuns = reader.GetU64();
+    int savedStatsWave = reader.GetI32();
+    reader.Skip(5 * sizeof(uint32_t));  // counts, read below
+
+    const float playerFloats[] = {saved.position.x, saved.position.y, saved.speed, saved.baseSpeed, saved.radius,
+                                  saved.shieldTimer};
+    for (float value : playerFloats) {
+        if (!std::isfinite(value)) return false;
+    }
+    if (saved.maxHealth <= 0 || saved.health < 0 || saved.health > saved.maxHealth) return false;
+    if (savedWave < 1 || savedStatsWave < 1 || savedPendingWave < 0 || savedPendingSpawns < 0) return false;
+    if (savedHorde.spawnPerStep <= 0 || savedHorde.aliveCap <= 0 ||
+        savedHorde.aliveCap > HordeSettings::maxAliveCap) {
+        return false;
+    }
+
+    SnapshotReader counts(data + snapshotHeaderBytes - 5 * sizeof(uint32_t));
+    uint64_t enemyCount = counts.GetU32();
+    uint64_t bulletCount = counts.GetU32();
+    uint64_t powerUpCount = counts.GetU32();
+    uint64_t explosionCount = counts.GetU32();
+    uint64_t effectCount = counts.GetU32();
+    uint64_t expected = snapshotHeaderBytes + enemyCount * snapshotEnemyBytes + bulletCount * snapshotBulletBytes +
+                        powerUpCount * snapshotPowerUpBytes + explosionCount * snapshotExplosionBytes +
+                        effectCount * snapshotEffectBytes;
+    if (expected != size || bulletCount > bullets.Capacity()) return false;
+
+    // Check every enum byte before touching the sim, so a bad blob changes nothing.
+    const uint8_t* record = data + snapshotHeaderBytes;
+    for (uint64_t i = 0; i < enemyCount; i++, record += snapshotEnemyBytes) {
+        if (record[0] >= enemyArchetypeCount) return false;
+    }
+    for (uint64_t i = 0; i < bulletCount; i++, record += snapshotBulletBytes) {
+        if (record[0] > static_cast<uint8_t>(ProjectileType::ROCKET)) return false;
+    }
+    for (uint64_t i = 0; i < powerUpCount; i++, record += snapshotPowerUpBytes) {
+        if (record[0] > static_cast<uint8_t>(PowerUpType::HEALTH_PACK)) return false;
+    }
+    record += explosionCount * snapshotExplosionBytes;
+    for (uint64_t i = 0; i < effectCount; i++, record += snapshotEffectBytes) {
+        if (record[0] >= static_cast<uint8_t>(PowerUpType::HEALTH_PACK)) return false;  // health packs are never timed
+    }
+
+    SetWorldSize(width, height);
+
+    player = saved;
+    currentWave = savedWave;
+    enemiesRemaining = savedRemaining;
+    pendingSpawns = savedPendingSpawns;
+    pendingWave = savedPendingWave;
+    gameOver = savedGameOver;
+    fireTimer = savedFireTimer;
+    powerUpSpawnTimer = savedPowerUpSpawnTimer;
+    permanentHealthMultiplier = savedHealthMultiplier;
+    permanentFireRateMultiplier = savedFireRateMultiplier;
+    permanentDamageMultiplier = savedDamageMultiplier;
+    horde = savedHorde;
+    rng.Seed(savedSeed);
+    rng.waveSpawn.Skip(savedCounters[0]);
+    rng.enemyTraits.Skip(savedCounters[1]);
+    rng.drops.Skip(savedCounters[2]);
+    rng.fieldPowerUps.Skip(savedCounters[3]);
+    runsStarted = savedRuns;
+    enemyStats = ScaleEnemyArchetypes(savedStatsWave);
+
+    // Same roster sizing as SpawnWave, so the steps after a restore stay off the heap too.
+    size_t roster = static_cast<size_t>(enemyCount);
+    if (horde.enabled) {
+        size_t streamed = std::min(roster + static_cast<size_t>(std::max(pendingSpawns, 0)),
+                                   static_cast<size_t>(std::max(horde.aliveCap, 1)));
+        roster = std::max(roster, streamed);
+    }
+    enemies.Clear();
+    enemies.Reserve(roster);
+    ReserveScratch(roster);
+    const float timerStep = kEnemyTimerPeriod / 65536.f;
+    for (uint64_t i = 0; i < enemyCount; i++) {
+        EnemyType type = static_cast<EnemyType>(reader.GetU8());
+        float flash = static_cast<float>(reader.GetU8()) * 0.001f;
+        Vector2 position;
+        position.x = reader.GetCoord();
+        position.y = reader.GetCoord();
+        Enemy enemy(position, type, enemyStats, 0.f);
+        enemy.flashTimer = flash;
+        enemy.facing.x = static_cast<float>(static_cast<int8_t>(reader.GetU8())) * (1.f / 127.f);
+        enemy.facing.y = static_cast<float>(static_cast<int8_t>(reader.GetU8())) * (1.f / 127.f);
+        enemy.behaviorTimer = static_cast<float>(reader.GetU16()) * timerStep;
+        enemy.health = reader.GetU16();
+        enemies.Push(enemy);
+    }
+
+    bullets.Clear();
+    for (uint64_t i = 0; i < bulletCount; i++) {
+        ProjectileType type = static_cast<ProjectileType>(reader.GetU8());
+        Vector2 position;
+        position.x = reader.GetCoord();
+        position.y = reader.GetCoord();
+        Vector2 velocity;
+        velocity.x = reader.GetFloat();
+        velocity.y = reader.GetFloat();
+        int damage = reader.GetI32();
+        Color color;
+        color.r = reader.GetU8();
+        color.g = reader.GetU8();
+        color.b = reader.GetU8();
+        color.a = reader.GetU8();
+        float explosionRadius = reader.GetFloat();
+        bullets.Push(Bullet(position, velocity, damage, color, type, explosionRadius));
+    }
+
+    powerUps.clear();
+    for (uint64_t i = 0; i < powerUpCount; i++) {
+        PowerUpType type = static_cast<PowerUpType>(reader.GetU8());
+        Vector2 position;
+        position.x = reader.GetCoord();
+        position.y = reader.GetCoord();
+        powerUps.push_back(MakePowerUp(type, position));
+    }
+
+    explosions.clear();
+    for (uint64_t i = 0; i < explosionCount; i++) {
+        Explosion explosion;
+        explosion.position.x = reader.GetCoord();
+        explosion.position.y = reader.GetCoord();
+        explosion.radius = reader.GetFloat();
+        explosion.lifetime = reader.GetFloat();
+        explosion.elapsed = reader.GetFloat();
+        explosion.damage = reader.GetI32();
+        explosion.applied = reader.GetU8() != 0;
+        explosions.push_back(explosion);
+    }
+
+    // Re-adding soonest first keeps the saved expiry order, ties included.
+    powerUpEffects.Clear();
+    for (uint64_t i = 0; i < effectCount; i++) {
+        PowerUpType type = static_cast<PowerUpType>(reader.GetU8());
+        GrantPowerUp(type, reader.GetFloat());
+    }
+    // player.speed came back with the rest of the player; don't re-derive it next step.
+    appliedEffectsVersion = powerUpEffects.Rebuilds();
+    return true;
+}
+
+inline void GameSim::KillEnemy(size_t index) {
+    enemies.dead[index] = 1;
+    enemiesRemaining--;
+}
+
+// Contact kills the enemy; a shield charge absorbs the damage.
+inline void GameSim::ResolveContact(size_t i) {
+    Vector2 enemyPos = enemies.Position(i);
+    bool blocked = false;
+    if (player.shieldCharges > 0) {
+        player.shieldCharges--;
+        blocked = true;
+        if (player.shieldCharges <= 0) powerUpEffects.Remove(static_cast<int>(PowerUpType::SHIELD));
+    } else {
+        player.health -= enemyStats.contactDamage[enemies.type[i]];
+        if (player.health < 0) player.health = 0;
+    }
+    events.playerHits++;
+    TryDropPowerUp(enemyPos);
+    KillEnemy(i);
+    if (!blocked && player.health <= 0) {
+        gameOver = true;
+        events.gameOver = true;
+    }
+}
+
+inline void GameSim::ResolveBulletHit(size_t i, int j) {
+    Vector2 enemyPos = enemies.Position(i);
+    const Bullet &projectile = bullets[j];
+    Vector2 knockbackDir = Vector2Subtract(enemyPos, projectile.position);
+    if (Vector2Length(knockbackDir) > 0.f) knockbackDir = Vector2Normalize(knockbackDir);
+    float knockbackStrength = projectile.type == ProjectileType::ROCKET ? 70.f : 40.f;
+    enemies.ApplyHit(i, projectile.damage, knockbackDir, knockbackStrength);
+    events.enemyHits++;
+    Vector2 deathPos = enemies.Position(i);
+    bullets[j].spent = true;
+    if (projectile.type == ProjectileType::ROCKET) {
+        float radius = projectile.explosionRadius > 0.f ? projectile.explosionRadius : rocketExplosionRadius;
+        SpawnExplosion(deathPos, radius, projectile.damage);
+    }
+    if (enemies.health[i] <= 0) {
+        TryDropPowerUp(deathPos);
+        KillEnemy(i);
+    }
+}
+
+inline SimEvents GameSim::Step(const InputFrame& input, float delta) {
+    PROFILE_SCOPE(ProfilePhase::SIM_STEP);
+    events = SimEvents{};
+    scratch.Reset();
+    player.previousPosition = player.position;
+    enemies.SavePreviousPositions();
+
+    PROFILE_SECTION(section, ProfilePhase::ENEMY_SPAWN);
+    StreamSpawns();
+
+    PROFILE_NEXT(section, ProfilePhase::POWERUP_SPAWN);
+
+    if (fireTimer > 0.f) {
+        fireTimer -= delta;
+        if (fireTimer < 0.f) fireTimer = 0.f;
+    }
+
+    if (powerUpSpawnTimer > 0.f) {
+        powerUpSpawnTimer -= delta;
+    }
+    if (powerUpSpawnTimer <= 0.f && (int)powerUps.size() < maxFieldPowerUps) {
+        int minX = 80, maxX = static_cast<int>(worldWidth) - 80;
+        int minY = 80, maxY = static_cast<int>(worldHeight) - 80;
+        Vector2 spawnPos = {0.f, 0.f};
+        bool foundSpot = false;
+        int attempts = 0;
+        do {
+            spawnPos = {
+                static_cast<float>(rng.fieldPowerUps.Range(minX, maxX)),
+                static_cast<float>(rng.fieldPowerUps.Range(minY, maxY))
+            };
+            bool nearPlayer = Vector2Distance(spawnPos, player.position) < 140.f;
+            bool overlaps = false;
+            for (auto &existing : powerUps) {
+                if (Vector2Distance(spawnPos, existing.position) < existing.radius + 50.f) {
+                    overlaps = true;
+                    break;
+                }
+            }
+            foundSpot = !nearPlayer && !overlaps;
+            attempts++;
+        } while (!foundSpot && attempts < 12);
+        if (!foundSpot) {
+            spawnPos = {
+                static_cast<float>(rng.fieldPowerUps.Range(minX, maxX)),
+                static_cast<float>(rng.fieldPowerUps.Range(minY, maxY))
+            };
+        }
+        SpawnRandomPowerUp(spawnPos, rng.fieldPowerUps);
+        powerUpSpawnTimer = RollPowerUpSpawnInterval();
+    }
+
+    PROFILE_NEXT(section, ProfilePhase::POWERUP_EFFECTS);
+    powerUpEffects.Advance(delta, [this](const ModifierStack::Effect& effect) {
+        if (effect.key == static_cast<int>(PowerUpType::SHIELD)) {
+            player.shieldCharges = 0;
+            player.shieldTimer = 0.f;
+        }
+    });
+    // Movement uses the stats as of the start of the step; pickups below take effect next step.
+    if (powerUpEffects.Rebuilds() != appliedEffectsVersion) {
+        ApplyPowerStats(powerUpEffects.Stats());
+        appliedEffectsVersion = powerUpEffects.Rebuilds();
+    }
+
+    PROFILE_NEXT(section, ProfilePhase::PLAYER);
+    Vector2 moveInput = input.move;
+    if (Vector2Length(moveInput) > 1.f) moveInput = Vector2Normalize(moveInput);
+    player.Update(delta, moveInput, worldWidth, worldHeight);
+
+    bool pickedPowerUp = false;
+    auto collected = [&](const PowerUp& powerUp) {
+        return CheckCollisionCircles(player.position, player.radius + 6.f, powerUp.position, powerUp.radius);
+    };
+    for (auto &powerUp : powerUps) {
+        if (collected(powerUp)) {
+            ActivatePowerUp(powerUp.type);
+            pickedPowerUp = true;
+        }
+    }
+    if (pickedPowerUp) {
+        // Compact before anything can drop new pickups, so the field cap sees the real count.
+        RemoveDead(powerUps, collected);
+    }
+    PowerStats stats = powerUpEffects.Stats();
+
+    if (stats.shieldRemaining > 0.f) player.shieldTimer = stats.shieldRemaining;
+    else if (player.shieldCharges <= 0) player.shieldTimer = 0.f;
+
+    PROFILE_NEXT(section, ProfilePhase::FIRE);
+    if (input.fire && fireTimer <= 0.f) FireWeapon(stats, input.aim);
+
+    PROFILE_NEXT(section, ProfilePhase::BULLETS);
+    for (auto &bullet : bullets) {
+        bullet.Update(delta);
+        if (bullet.IsOffScreen(worldWidth, worldHeight)) {
+            if (bullet.type == ProjectileType::ROCKET) {
+                float radius = bullet.explosionRadius > 0.f ? bullet.explosionRadius : rocketExplosionRadius;
+                SpawnExplosion(bullet.position, radius, bullet.damage);
+            }
+            bullet.spent = true;
+        }
+    }
+
+    PROFILE_NEXT(section, ProfilePhase::ENEMY_MOVE);
+    // Movement only reads the player position and writes its own enemy's slots, so the
+    // population moves in parallel chunks; contacts, damage and drops then resolve
+    // serially in index order, which keeps every run identical for any thread count.
+    // With walls, each chunk first looks up its enemies' flow-field targets; without them
+    // every enemy heads straight for the player and the lookup is skipped.
+    Vector2 playerPos = player.position;
+    flowField.Update(playerPos);
+    bool routed = flowField.HasWalls();
+    ArenaVector<float> targetX{ArenaAllocator<float>(scratch)};
+    ArenaVector<float> targetY{ArenaAllocator<float>(scratch)};
+    if (routed) {
+        targetX.resize(enemies.Size());
+        targetY.resize(enemies.Size());
+    }
+    auto moveChunk = [this, playerPos, delta, routed, &targetX, &targetY](size_t begin, size_t end) {
+        if (!routed) {
+            UpdateEnemyMovement(enemies, begin, end, playerPos, delta);
+            return;
+        }
+        for (size_t i = begin; i < end; i++) {
+            Vector2 target = flowField.Target(enemies.Position(i), playerPos);
+            targetX[i] = target.x;
+            targetY[i] = target.y;
+        }
+        UpdateEnemyMovement(enemies, begin, end, playerPos, delta, targetX.data(), targetY.data());
+    };
+    if (jobs) jobs->ParallelFor(0, enemies.Size(), enemyMoveChunk, moveChunk);
+    else moveChunk(0, enemies.Size());
+
+    PROFILE_NEXT(section, ProfilePhase::ENEMY_SEPARATION);
+    if (crowdSeparation) SeparateEnemies(delta);
+
+    // Bullets don't move during the enemy pass, only get consumed, so bucket them once.
+    PROFILE_NEXT(section, ProfilePhase::COLLISION);
+    BuildBulletGrid();
+    if (!ParallelCollisions()) {
+        // One first-hit search per enemy, resolved as it goes; the order is the one the
+        // gathered path reproduces below.
+        for (size_t i = 0; i < enemies.Size(); i++) {
+            if (CheckCollisionCircles(player.position, player.radius, enemies.Position(i), enemies.radius[i])) {
+                ResolveContact(i);
+                continue;
+            }
+            int j = FindBulletHit(enemies.Position(i), enemies.radius[i]);
+            if (j >= 0) ResolveBulletHit(i, j);
+        }
+    } else {
+        ArenaVector<uint64_t> collisionKeys{ArenaAllocator<uint64_t>(scratch)};
+        GatherCollisions(collisionKeys);
+        // Serial resolve, one enemy group at a time in index order. Detection only read state
+        // this pass never changes (player and bullet positions, each enemy's own pre-hit
+        // position), so the first still-unspent bullet in a group is the one the serial
+        // per-enemy search would have found.
+        for (size_t k = 0; k < collisionKeys.size();) {
+            size_t i = static_cast<size_t>(collisionKeys[k] >> 32);
+            size_t groupEnd = k + 1;
+            while (groupEnd < collisionKeys.size() && static_cast<size_t>(collisionKeys[groupEnd] >> 32) == i) groupEnd++;
+            size_t first = k;
+            k = groupEnd;
+
+            if ((collisionKeys[first] & 0xFFFFFFFFull) == 0) {
+                ResolveContact(i);
+                continue;
+            }
+
+            int j = -1;
+            for (size_t h = first; h < groupEnd && j < 0; h++) {
+                uint64_t slot = collisionKeys[h] & 0xFFFFFFFFull;
+                if (slot == collisionOverflow) {
+                    // Every kept candidate was taken by an earlier enemy; search the rest exactly.
+                    j = FindBulletHit(enemies.Position(i), enemies.radius[i]);
+                    break;
+                }
+                if (!bullets[slot - 1].spent) j = static_cast<int>(slot - 1);
+            }
+            if (j >= 0) ResolveBulletHit(i, j);
+        }
+    }
+    bullets.RemoveIf([](const Bullet& bullet) { return bullet.spent; });
+
+    PROFILE_NEXT(section, ProfilePhase::EXPLOSIONS);
+    bool gridBuilt = false;
+    ArenaVector<int> explosionHits{ArenaAllocator<int>(scratch)};
+    for (auto &explosion : explosions) {
+        if (explosion.applied) continue;
+        if (!gridBuilt) {
+            BuildEnemyGrid();
+            explosionHits.reserve(enemies.Size());
+            gridBuilt = true;
+        }
+        QueryEnemiesInRadius(explosion.position, explosion.radius, explosionHits);
+        for (int idx : explosionHits) {
+            Vector2 enemyPos = enemies.Position(idx);
+            Vector2 knockDir = Vector2Subtract(enemyPos, explosion.position);
+            if (Vector2Length(knockDir) > 0.f) knockDir = Vector2Normalize(knockDir);
+            enemies.ApplyHit(idx, explosion.damage, knockDir, explosionKnockback);
+            if (enemies.health[idx] <= 0) {
+                TryDropPowerUp(enemies.Position(idx));
+                KillEnemy(idx);
+            }
+        }
+        // Survivors were pushed at most one knockback away from their bucketed position.
+        if (!explosionHits.empty()) enemyGridSlack += explosionKnockback;
+        explosion.applied = true;
+    }
+    PROFILE_NEXT(section, ProfilePhase::CLEANUP);
+    enemies.RemoveDead();
+
+    for (auto &explosion : explosions) explosion.elapsed += delta;
+    RemoveDead(explosions, [](const Explosion& explosion) { return explosion.elapsed >= explosion.lifetime; });
+
+    if (enemiesRemaining < 0) enemiesRemaining = 0;
+
+    if (enemiesRemaining <= 0 && !gameOver) {
+        enemiesRemaining = 0;
+        pendingWave = currentWave + 1;
+        events.waveCleared = true;
+    }
+    return events;
+}
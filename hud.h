@@ -0,0 +1,221 @@
+#pragma once
+
+#include "raylib.h"
+#include "rlgl.h"
+#include "game_sim.h"
+#include <vector>
+#include <cstdio>
+#include <cstring>
+
+// =====================================================
+// Retained HUD
+// Strings are formatted and measured only when the values behind them change.
+// The gameplay HUD is painted into a render target on change and composited
+// with a single textured quad on every other frame.
+// =====================================================
+
+// One string bound to a printf format taking up to two ints.
+class HudText {
+public:
+    HudText(const char* format, int fontSize) : format(format), fontSize(fontSize) { text[0] = '\0'; }
+
+    // Returns true when the text changed (and was re-measured).
+    bool Set(int a, int b = 0) {
+        if (valid && a == keyA && b == keyB) return false;
+        keyA = a;
+        keyB = b;
+        valid = true;
+        snprintf(text, sizeof(text), format, a, b);
+        width = MeasureText(text, fontSize);
+        return true;
+    }
+
+    const char* Text() const { return text; }
+    int Width() const { return width; }
+    int FontSize() const { return fontSize; }
+
+private:
+    const char* format;
+    int fontSize;
+    int keyA = 0;
+    int keyB = 0;
+    bool valid = false;
+    int width = 0;
+    char text[64];
+};
+
+// A copied string whose width is re-measured only when the source text changes.
+class HudLabel {
+public:
+    explicit HudLabel(int fontSize) : fontSize(fontSize) { text[0] = '\0'; }
+
+    bool Set(const char* source) {
+        if (valid && strncmp(text, source, sizeof(text) - 1) == 0) return false;
+        snprintf(text, sizeof(text), "%s", source);
+        width = MeasureText(text, fontSize);
+        valid = true;
+        return true;
+    }
+
+    const char* Text() const { return text; }
+    int Width() const { return width; }
+
+private:
+    int fontSize;
+    bool valid = false;
+    int width = 0;
+    char text[128];
+};
+
+// Power-up labels never change, so each width is measured once.
+inline int PowerUpLabelWidth(PowerUpType type, int fontSize) {
+    static int widths[7] = {-1, -1, -1, -1, -1, -1, -1};
+    static int measuredSize = -1;
+    if (measuredSize != fontSize) {
+        for (int& w : widths) w = -1;
+        measuredSize = fontSize;
+    }
+    int& width = widths[static_cast<int>(type)];
+    if (width < 0) width = MeasureText(GetPowerUpLabel(type), fontSize);
+    return width;
+}
+
+class GameplayHud {
+public:
+    static constexpr int maxEffectRows = 6;  // every timed power-up at once
+    static constexpr int height = 272;       // top strip covering bar, counters and effect boxes
+
+    GameplayHud() : effectTimers(maxEffectRows, HudText("%d.%ds", 14)) {}
+
+    // Refreshes cached values, repaints the target if anything changed, then composites it.
+    void Draw(const GameSim& sim, int screenWidth);
+    void Unload();
+
+    int Repaints() const { return repaints; }
+
+private:
+    HudText healthText{"%d / %d", 16};
+    HudText shieldText{"Shield: %d", 18};
+    HudText waveText{"Wave %d", 22};
+    HudText remainingText{"Remaining: %d", 20};
+    std::vector<HudText> effectTimers;
+
+    int barFill = -1;
+    bool barLow = false;
+    int effectCount = -1;
+    int effectTypes[maxEffectRows] = {};
+
+    RenderTexture2D target = {};
+    int targetWidth = 0;
+    bool dirty = true;
+    int repaints = 0;
+
+    bool Refresh(const GameSim& sim);
+    void Paint(const GameSim& sim, int screenWidth) const;
+};
+
+inline bool GameplayHud::Refresh(const GameSim& sim) {
+    const Player& player = sim.player;
+    bool changed = false;
+    float healthPercent = static_cast<float>(player.health) / static_cast<float>(player.maxHealth);
+    if (healthPercent < 0.f) healthPercent = 0.f;
+    int fill = static_cast<int>(220.f * healthPercent);
+    bool low = !(healthPercent > 0.35f);
+    if (fill != barFill || low != barLow) {
+        barFill = fill;
+        barLow = low;
+        changed = true;
+    }
+    changed |= healthText.Set(player.health, player.maxHealth);
+    changed |= shieldText.Set(player.shieldCharges);
+    changed |= waveText.Set(sim.currentWave);
+    changed |= remainingText.Set(sim.enemiesRemaining);
+
+    const std::vector<ModifierStack::Effect>& effects = sim.powerUpEffects.Effects();
+    int count = std::min(static_cast<int>(effects.size()), maxEffectRows);
+    if (count != effectCount) {
+        effectCount = count;
+        changed = true;
+    }
+    for (int i = 0; i < count; i++) {
+        const ModifierStack::Effect& effect = effects[i];
+        int type = effect.key;
+        if (type != effectTypes[i]) {
+            effectTypes[i] = type;
+            changed = true;
+        }
+        int tenths = static_cast<int>(std::lround(sim.powerUpEffects.Remaining(effect) * 10.f));
+        if (tenths < 0) tenths = 0;
+        changed |= effectTimers[i].Set(tenths / 10, tenths % 10);
+    }
+    return changed;
+}
+
+// Same layout as the old immediate-mode HUD, in target space (top-left origin).
+inline void GameplayHud::Paint(const GameSim& sim, int screenWidth) const {
+    const float barWidth = 220.f;
+    const float barHeight = 22.f;
+    DrawRectangle(20, 20, static_cast<int>(barWidth), static_cast<int>(barHeight), Fade(DARKGRAY, 0.8f));
+    DrawRectangle(20, 20, barFill, static_cast<int>(barHeight), barLow ? MAROON : GREEN);
+    DrawRectangleLines(20, 20, static_cast<int>(barWidth), static_cast<int>(barHeight), BLACK);
+    DrawText(healthText.Text(), 30, 24, healthText.FontSize(), WHITE);
+    if (sim.player.shieldCharges > 0) {
+        DrawText(shieldText.Text(), 20, 110, shieldText.FontSize(), SKYBLUE);
+    }
+
+    DrawText(waveText.Text(), 20, 60, waveText.FontSize(), YELLOW);
+    DrawText(remainingText.Text(), 20, 90, remainingText.FontSize(), LIGHTGRAY);
+
+    for (int i = 0; i < effectCount; i++) {
+        PowerUpType type = static_cast<PowerUpType>(effectTypes[i]);
+        Rectangle box = {static_cast<float>(screenWidth - 160), 20.f + i * 40.f, 140.f, 32.f};
+        DrawRectangleRounded(box, 0.25f, 8, Fade(GetPowerUpColor(type), 0.75f));
+        DrawRectangleRoundedLines(box, 0.25f, 8, Fade(BLACK, 0.5f));
+        DrawText(GetPowerUpLabel(type), static_cast<int>(box.x + 12.f), static_cast<int>(box.y + 8.f), 18, WHITE);
+        DrawText(effectTimers[i].Text(), static_cast<int>(box.x + 12.f), static_cast<int>(box.y + 20.f),
+                 effectTimers[i].FontSize(), LIGHTGRAY);
+    }
+}
+
+inline void GameplayHud::Draw(const GameSim& sim, int screenWidth) {
+    if (Refresh(sim)) dirty = true;
+
+    if (targetWidth != screenWidth) {
+        if (target.id != 0) UnloadRenderTexture(target);
+        target = LoadRenderTexture(screenWidth, height);
+        targetWidth = screenWidth;
+        dirty = true;
+    }
+    if (target.id == 0) {
+        // No render target (context lost or unsupported): draw straight to the screen.
+        Paint(sim, screenWidth);
+        return;
+    }
+
+    if (dirty) {
+        BeginTextureMode(target);
+        ClearBackground(BLANK);
+        // Accumulate premultiplied colour with correct coverage so the composite matches direct drawing.
+        rlSetBlendFactorsSeparate(RL_SRC_ALPHA, RL_ONE_MINUS_SRC_ALPHA, RL_ONE, RL_ONE_MINUS_SRC_ALPHA,
+                                  RL_FUNC_ADD, RL_FUNC_ADD);
+        BeginBlendMode(BLEND_CUSTOM_SEPARATE);
+        Paint(sim, screenWidth);
+        EndBlendMode();
+        EndTextureMode();
+        dirty = false;
+        repaints++;
+    }
+
+    // Render textures are stored bottom-up, hence the negative source height.
+    BeginBlendMode(BLEND_ALPHA_PREMULTIPLY);
+    DrawTextureRec(target.texture, {0.f, 0.f, static_cast<float>(targetWidth), -static_cast<float>(height)},
+                   {0.f, 0.f}, WHITE);
+    EndBlendMode();
+}
+
+inline void GameplayHud::Unload() {
+    if (target.id != 0) UnloadRenderTexture(target);
+    target = RenderTexture2D{};
+    targetWidth = 0;
+    dirty = true;
+}
@@ -0,0 +1,220 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#if defined(WAVEBREAKER_NO_THREADS) || (defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__))
+#define JOB_SYSTEM_THREADS 0
+#else
+#define JOB_SYSTEM_THREADS 1
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+
+// =====================================================
+// Work-stealing job system
+// A fixed pool of workers, each with its own bounded job queue. ParallelFor deals
+// the chunks of a range round-robin across the queues (the calling thread owns
+// queue 0 and works too); a thread pops from the back of its own queue and, when
+// that runs dry, steals from the front of the others. Jobs are plain function
+// pointer + context records, so submitting never allocates.
+// Results only depend on how the body treats each index, never on which thread ran
+// which chunk, so a body that writes disjoint slots is deterministic for any
+// thread count. Web builds without pthreads (and -DWAVEBREAKER_NO_THREADS) run
+// every range inline.
+// =====================================================
+
+class JobSystem {
+public:
+    static constexpr size_t queueCapacity = 256;  // per thread; a full queue runs the chunk inline
+
+    // threadCount includes the calling thread, so 1 means fully serial.
+    explicit JobSystem(int threadCount = DefaultThreadCount());
+    ~JobSystem();
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    // Hardware threads, leaving one for the OS and audio, capped at 8.
+    static int DefaultThreadCount();
+
+    int ThreadCount() const { return threadCount; }
+    // Index of the calling thread inside its pool, in [0, ThreadCount()); the owner is 0.
+    // Lets a body write into per-thread buffers without locking.
+    static int ThreadIndex() { return CurrentThreadIndex(); }
+    uint64_t Steals() const { return steals.load(std::memory_order_relaxed); }
+
+    // Calls body(chunkBegin, chunkEnd) for consecutive chunks of [begin, end) and returns
+    // once all of them finished. Must be called from the thread that owns the system.
+    template <typename Body>
+    void ParallelFor(size_t begin, size_t end, size_t chunkSize, Body& body);
+
+private:
+    struct Job {
+        void (*run)(void* context, size_t begin, size_t end);
+        void* context;
+        size_t begin;
+        size_t end;
+        std::atomic<size_t>* pending;
+    };
+
+    int threadCount;
+    std::atomic<uint64_t> steals{0};
+
+#if JOB_SYSTEM_THREADS
+    struct Queue {
+        std::mutex lock;
+        Job jobs[queueCapacity];
+        size_t head = 0;  // oldest job, taken by thieves
+        size_t tail = 0;  // newest job, taken by the owner
+
+        bool Push(const Job& job);
+        bool PopBack(Job& job);
+        bool StealFront(Job& job);
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues;  // separate allocations; queues[0] belongs to the calling thread
+    std::vector<std::thread> workers;
+    std::mutex sleepLock;
+    std::condition_variable wake;
+    std::atomic<size_t> queuedJobs{0};
+    bool stopping = false;  // guarded by sleepLock
+
+    void WorkerLoop(size_t index);
+    bool RunOne(size_t index);
+#endif
+
+    static int& CurrentThreadIndex() {
+        static thread_local int index = 0;
+        return index;
+    }
+
+    static void Execute(const Job& job) {
+        job.run(job.context, job.begin, job.end);
+        job.pending->fetch_sub(1, std::memory_order_release);
+    }
+};
+
+template <typename Body>
+inline void JobSystem::ParallelFor(size_t begin, size_t end, size_t chunkSize, Body& body) {
+    if (end <= begin) return;
+    if (chunkSize == 0) chunkSize = 1;
+    size_t chunks = (end - begin + chunkSize - 1) / chunkSize;
+#if JOB_SYSTEM_THREADS
+    if (threadCount <= 1 || chunks <= 1) {
+        body(begin, end);
+        return;
+    }
+
+    std::atomic<size_t> pending{chunks};
+    auto run = [](void* context, size_t chunkBegin, size_t chunkEnd) {
+        (*static_cast<Body*>(context))(chunkBegin, chunkEnd);
+    };
+    for (size_t c = 0; c < chunks; c++) {
+        size_t chunkBegin = begin + c * chunkSize;
+        size_t chunkEnd = chunkBegin + chunkSize < end ? chunkBegin + chunkSize : end;
+        Job job = {run, &body, chunkBegin, chunkEnd, &pending};
+        // Counted before the push so a thief never sees the job without the count.
+        queuedJobs.fetch_add(1, std::memory_order_release);
+        if (!queues[c % queues.size()]->Push(job)) {
+            queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+            Execute(job);
+        }
+    }
+    {
+        // Taking the lock orders the pushes before any sleeping worker re-checks queuedJobs.
+        std::lock_guard<std::mutex> guard(sleepLock);
+    }
+    wake.notify_all();
+
+    while (pending.load(std::memory_order_acquire) > 0) {
+        if (!RunOne(0)) std::this_thread::yield();
+    }
+#else
+    (void)chunks;
+    body(begin, end);
+#endif
+}
+
+#if JOB_SYSTEM_THREADS
+
+inline int JobSystem::DefaultThreadCount() {
+    int hardware = static_cast<int>(std::thread::hardware_concurrency());
+    int count = hardware > 1 ? hardware - 1 : 1;
+    return count > 8 ? 8 : count;
+}
+
+inline JobSystem::JobSystem(int threadCount) : threadCount(threadCount < 1 ? 1 : threadCount) {
+    for (int i = 0; i < this->threadCount; i++) queues.emplace_back(new Queue());
+    for (int i = 1; i < this->threadCount; i++) {
+        workers.emplace_back(&JobSystem::WorkerLoop, this, static_cast<size_t>(i));
+    }
+}
+
+inline JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> guard(sleepLock);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& worker : workers) worker.join();
+}
+
+inline bool JobSystem::Queue::Push(const Job& job) {
+    std::lock_guard<std::mutex> guard(lock);
+    if (tail - head >= queueCapacity) return false;
+    jobs[tail % queueCapacity] = job;
+    tail++;
+    return true;
+}
+
+inline bool JobSystem::Queue::PopBack(Job& job) {
+    std::lock_guard<std::mutex> guard(lock);
+    if (tail == head) return false;
+    tail--;
+    job = jobs[tail % queueCapacity];
+    return true;
+}
+
+inline bool JobSystem::Queue::StealFront(Job& job) {
+    std::lock_guard<std::mutex> guard(lock);
+    if (tail == head) return false;
+    job = jobs[head % queueCapacity];
+    head++;
+    return true;
+}
+
+// Runs one job from this thread's queue, or steals one; false when every queue is empty.
+inline bool JobSystem::RunOne(size_t index) {
+    Job job;
+    bool found = queues[index]->PopBack(job);
+    for (size_t offset = 1; !found && offset < queues.size(); offset++) {
+        found = queues[(index + offset) % queues.size()]->StealFront(job);
+        if (found) steals.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (!found) return false;
+    queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+    Execute(job);
+    return true;
+}
+
+inline void JobSystem::WorkerLoop(size_t index) {
+    CurrentThreadIndex() = static_cast<int>(index);
+    for (;;) {
+        if (RunOne(index)) continue;
+        std::unique_lock<std::mutex> guard(sleepLock);
+        wake.wait(guard, [this] { return stopping || queuedJobs.load(std::memory_order_acquire) > 0; });
+        if (stopping) return;
+    }
+}
+
+#else
+
+inline int JobSystem::DefaultThreadCount() { return 1; }
+inline JobSystem::JobSystem(int) : threadCount(1) {}
+inline JobSystem::~JobSystem() {}
+
+#endif
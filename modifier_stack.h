@@ -0,0 +1,142 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+
+// =====================================================
+// Timed modifier stack
+// Holds the timed effects on the player, sorted by deadline on one running clock.
+// Advance only looks at the front of the list, so an idle frame costs one comparison
+// however many effects are active. The combined PowerStats are cached and rebuilt only
+// when an effect is added, refreshed or removed. Effects are keyed by an int (the game
+// uses PowerUpType), and a key can be active at most once: adding it again resets its
+// deadline.
+// =====================================================
+
+struct PowerStats {
+    float speedMultiplier = 1.f;
+    float fireRateMultiplier = 1.f;
+    float damageMultiplier = 1.f;
+    int spreadLevel = 0;
+    float shieldRemaining = 0.f;
+    bool rocketLauncher = false;
+};
+
+// What one effect contributes: multipliers stack multiplicatively, the rest take the max.
+struct Modifier {
+    float speedMultiplier = 1.f;
+    float fireRateMultiplier = 1.f;
+    float damageMultiplier = 1.f;
+    int spreadLevel = 0;
+    bool shield = false;
+    bool rocketLauncher = false;
+};
+
+class ModifierStack {
+public:
+    struct Effect {
+        int key;
+        double deadline;
+        Modifier modifier;
+    };
+
+    void Reserve(size_t count) { effects.reserve(count); }
+    void Clear();
+
+    // Starts the effect, or restarts the clock on it if `key` is already active.
+    void Add(int key, const Modifier& modifier, float duration);
+    bool Remove(int key);
+
+    // Moves the clock forward and drops everything whose deadline passed, calling
+    // onExpire(effect) for each one first, soonest first.
+    template <typename OnExpire>
+    void Advance(float delta, OnExpire&& onExpire);
+
+    // Cached aggregate; shieldRemaining is filled in from the clock on each call.
+    PowerStats Stats() const {
+        PowerStats stats = cached;
+        if (shieldDeadline > clock) stats.shieldRemaining = static_cast<float>(shieldDeadline - clock);
+        return stats;
+    }
+    float Remaining(const Effect& effect) const { return static_cast<float>(std::max(0.0, effect.deadline - clock)); }
+
+    // Active effects, soonest deadline first.
+    const std::vector<Effect>& Effects() const { return effects; }
+    size_t Size() const { return effects.size(); }
+    // How often the aggregate was rebuilt; only add, refresh and expiry should move it.
+    uint64_t Rebuilds() const { return rebuilds; }
+
+private:
+    std::vector<Effect> effects;
+    double clock = 0.0;
+    double shieldDeadline = 0.0;
+    PowerStats cached;
+    uint64_t rebuilds = 0;
+
+    void Insert(const Effect& effect);
+    bool Erase(int key);
+    void Rebuild();
+};
+
+inline void ModifierStack::Clear() {
+    effects.clear();
+    Rebuild();
+}
+
+inline void ModifierStack::Insert(const Effect& effect) {
+    // After any equal deadlines, so effects that expire together do so in the order they were added.
+    auto at = std::upper_bound(effects.begin(), effects.end(), effect.deadline,
+                               [](double deadline, const Effect& other) { return deadline < other.deadline; });
+    effects.insert(at, effect);
+}
+
+inline bool ModifierStack::Erase(int key) {
+    for (size_t i = 0; i < effects.size(); i++) {
+        if (effects[i].key != key) continue;
+        effects.erase(effects.begin() + static_cast<std::ptrdiff_t>(i));
+        return true;
+    }
+    return false;
+}
+
+inline void ModifierStack::Add(int key, const Modifier& modifier, float duration) {
+    Erase(key);
+    Insert({key, clock + duration, modifier});
+    Rebuild();
+}
+
+inline bool ModifierStack::Remove(int key) {
+    if (!Erase(key)) return false;
+    Rebuild();
+    return true;
+}
+
+template <typename OnExpire>
+inline void ModifierStack::Advance(float delta, OnExpire&& onExpire) {
+    clock += delta;
+    size_t expired = 0;
+    while (expired < effects.size() && effects[expired].deadline <= clock) {
+        onExpire(effects[expired]);
+        expired++;
+    }
+    if (expired == 0) return;
+    effects.erase(effects.begin(), effects.begin() + static_cast<std::ptrdiff_t>(expired));
+    Rebuild();
+}
+
+inline void ModifierStack::Rebuild() {
+    rebuilds++;
+    cached = PowerStats{};
+    shieldDeadline = 0.0;
+    for (const Effect& effect : effects) {
+        const Modifier& m = effect.modifier;
+        cached.speedMultiplier *= m.speedMultiplier;
+        cached.fireRateMultiplier *= m.fireRateMultiplier;
+        cached.damageMultiplier *= m.damageMultiplier;
+        cached.spreadLevel = std::max(cached.spreadLevel, m.spreadLevel);
+        cached.rocketLauncher = cached.rocketLauncher || m.rocketLauncher;
+        if (m.shield) shieldDeadline = std::max(shieldDeadline, effect.deadline);
+    }
+}
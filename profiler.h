@@ -0,0 +1,311 @@
+#pragma once
+
+#include "raylib.h"
+#include "frame_arena.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+#include <algorithm>
+
+// =====================================================
+// Frame profiler
+// Scoped timers around each simulation and draw phase. Every frame the inclusive
+// time per phase is summed (the sim may step several times per frame) and kept in
+// a rolling window for the overlay's average and p99. CaptureTrace() records the
+// individual scopes of the next few frames and writes them as Chrome trace JSON,
+// which chrome://tracing and ui.perfetto.dev both open.
+// Build with -DFRAME_PROFILER=0 and the scope macros expand to nothing.
+// =====================================================
+
+#ifndef FRAME_PROFILER
+#define FRAME_PROFILER 1
+#endif
+
+enum class ProfilePhase {
+    SIM_STEP,
+    ENEMY_SPAWN,
+    POWERUP_SPAWN,
+    POWERUP_EFFECTS,
+    PLAYER,
+    FIRE,
+    BULLETS,
+    ENEMY_MOVE,
+    ENEMY_SEPARATION,
+    COLLISION,
+    EXPLOSIONS,
+    CLEANUP,
+    DRAW_GAMEPLAY,
+    DRAW_POWERUPS,
+    DRAW_PLAYER,
+    DRAW_ENTITIES,
+    DRAW_SUBMIT,
+    DRAW_HUD,
+    PRESENT,
+    COUNT
+};
+
+inline const char* GetProfilePhaseName(ProfilePhase phase) {
+    switch (phase) {
+        case ProfilePhase::SIM_STEP: return "Sim step";
+        case ProfilePhase::ENEMY_SPAWN: return "Enemy spawn";
+        case ProfilePhase::POWERUP_SPAWN: return "Power-up spawn";
+        case ProfilePhase::POWERUP_EFFECTS: return "Power-up effects";
+        case ProfilePhase::PLAYER: return "Player + pickups";
+        case ProfilePhase::FIRE: return "Fire";
+        case ProfilePhase::BULLETS: return "Bullets";
+        case ProfilePhase::ENEMY_MOVE: return "Enemy movement";
+        case ProfilePhase::ENEMY_SEPARATION: return "Enemy separation";
+        case ProfilePhase::COLLISION: return "Collision";
+        case ProfilePhase::EXPLOSIONS: return "Explosions";
+        case ProfilePhase::CLEANUP: return "Cleanup";
+        case ProfilePhase::DRAW_GAMEPLAY: return "DrawGameplay";
+        case ProfilePhase::DRAW_POWERUPS: return "Power-ups";
+        case ProfilePhase::DRAW_PLAYER: return "Player + gun";
+        case ProfilePhase::DRAW_ENTITIES: return "Build draw list";
+        case ProfilePhase::DRAW_SUBMIT: return "Submit draw list";
+        case ProfilePhase::DRAW_HUD: return "HUD";
+        case ProfilePhase::PRESENT: return "Present";
+        default: return "?";
+    }
+}
+
+// Nesting depth for the overlay; the sub-phases sit under SIM_STEP and DRAW_GAMEPLAY.
+inline int GetProfilePhaseDepth(ProfilePhase phase) {
+    return (phase == ProfilePhase::SIM_STEP || phase == ProfilePhase::DRAW_GAMEPLAY ||
+            phase == ProfilePhase::PRESENT) ? 0 : 1;
+}
+
+class FrameProfiler {
+public:
+    static constexpr bool enabled = FRAME_PROFILER != 0;
+    static constexpr int phaseCount = static_cast<int>(ProfilePhase::COUNT);
+    static constexpr int historyFrames = 240;
+    static constexpr int summaryInterval = 30;  // frames between overlay refreshes, so numbers stay readable
+
+    struct Summary {
+        float averageMs = 0.f;
+        float p99Ms = 0.f;
+    };
+
+    struct TraceEvent {
+        int phase;  // phaseCount marks a whole frame
+        uint64_t startNs;
+        uint64_t durationNs;
+    };
+
+    FrameProfiler();
+
+    static FrameProfiler& Instance() {
+        static FrameProfiler profiler;
+        return profiler;
+    }
+
+    static uint64_t NowNs() {
+        using namespace std::chrono;
+        return static_cast<uint64_t>(duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+    }
+
+    // Closes the current frame and opens the next; call once at the top of the main loop.
+    void NextFrame();
+    void Record(ProfilePhase phase, uint64_t startNs, uint64_t durationNs);
+
+    // Records every scope of the next `frames` frames, then writes them to `path`.
+    void CaptureTrace(int frames, const char* path);
+    bool Capturing() const { return captureFramesLeft > 0; }
+    bool WriteTrace(const char* path) const;
+
+    const Summary& GetSummary(ProfilePhase phase) const { return summaries[static_cast<int>(phase)]; }
+    // Time spent in a phase since the last NextFrame().
+    uint64_t CurrentFrameNs(ProfilePhase phase) const { return currentNs[static_cast<int>(phase)]; }
+    const Summary& GetFrameSummary() const { return frameSummary; }
+
+    bool overlayVisible = false;
+
+private:
+    uint64_t frameStartNs = 0;
+    uint64_t currentNs[phaseCount] = {};
+    std::vector<float> history;  // historyFrames rows of phaseCount + 1 (frame total last)
+    int historyHead = 0;
+    int historyCount = 0;
+    int framesSinceSummary = 0;
+    std::vector<float> scratch;
+    Summary summaries[phaseCount];
+    Summary frameSummary;
+
+    std::vector<TraceEvent> trace;
+    int captureFramesLeft = 0;
+    uint64_t captureStartNs = 0;
+    char capturePath[256] = {};
+
+    void RefreshSummaries();
+    Summary Summarize(int column);
+};
+
+// Times its own lifetime; Next() closes the current phase and opens another in one call,
+// for straight-line code like GameSim::Step.
+class ProfileScope {
+public:
+    explicit ProfileScope(ProfilePhase phase) : phase(phase), startNs(FrameProfiler::NowNs()) {}
+    ~ProfileScope() { Close(FrameProfiler::NowNs()); }
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+    void Next(ProfilePhase nextPhase) {
+        uint64_t now = FrameProfiler::NowNs();
+        Close(now);
+        phase = nextPhase;
+        startNs = now;
+    }
+
+private:
+    ProfilePhase phase;
+    uint64_t startNs;
+
+    void Close(uint64_t endNs) { FrameProfiler::Instance().Record(phase, startNs, endNs - startNs); }
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#if FRAME_PROFILER
+#define PROFILE_SCOPE(phase) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(phase)
+#define PROFILE_SECTION(name, phase) ProfileScope name(phase)
+#define PROFILE_NEXT(name, phase) name.Next(phase)
+#else
+#define PROFILE_SCOPE(phase) do {} while (0)
+#define PROFILE_SECTION(name, phase) do {} while (0)
+#define PROFILE_NEXT(name, phase) do {} while (0)
+#endif
+
+inline FrameProfiler::FrameProfiler() {
+    if (!enabled) return;
+    history.assign(static_cast<size_t>(historyFrames * (phaseCount + 1)), 0.f);
+    scratch.reserve(historyFrames);
+    frameStartNs = NowNs();
+}
+
+inline void FrameProfiler::Record(ProfilePhase phase, uint64_t startNs, uint64_t durationNs) {
+    if (!enabled) return;
+    currentNs[static_cast<int>(phase)] += durationNs;
+    if (captureFramesLeft > 0 && trace.size() < trace.capacity()) {
+        trace.push_back({static_cast<int>(phase), startNs, durationNs});
+    }
+}
+
+inline void FrameProfiler::NextFrame() {
+    if (!enabled) return;
+    uint64_t now = NowNs();
+    float* row = &history[static_cast<size_t>(historyHead * (phaseCount + 1))];
+    for (int i = 0; i < phaseCount; i++) {
+        row[i] = static_cast<float>(currentNs[i]) * 1e-6f;
+        currentNs[i] = 0;
+    }
+    row[phaseCount] = static_cast<float>(now - frameStartNs) * 1e-6f;
+    historyHead = (historyHead + 1) % historyFrames;
+    if (historyCount < historyFrames) historyCount++;
+
+    if (captureFramesLeft > 0) {
+        if (frameStartNs >= captureStartNs && trace.size() < trace.capacity()) {
+            trace.push_back({phaseCount, frameStartNs, now - frameStartNs});
+        }
+        if (--captureFramesLeft == 0) {
+            if (WriteTrace(capturePath)) TraceLog(LOG_INFO, "PROFILER: trace written to %s", capturePath);
+            else TraceLog(LOG_WARNING, "PROFILER: could not write %s", capturePath);
+            std::vector<TraceEvent>().swap(trace);
+        }
+    }
+    frameStartNs = now;
+
+    if (++framesSinceSummary >= summaryInterval) {
+        framesSinceSummary = 0;
+        RefreshSummaries();
+    }
+}
+
+inline void FrameProfiler::CaptureTrace(int frames, const char* path) {
+    if (!enabled || frames <= 0) return;
+    // Sized up front (generous per-frame scope budget) so capturing never reallocates mid-frame.
+    trace.clear();
+    trace.reserve(static_cast<size_t>(frames) * 512);
+    captureFramesLeft = frames;
+    captureStartNs = NowNs();
+    snprintf(capturePath, sizeof(capturePath), "%s", path);
+}
+
+inline bool FrameProfiler::WriteTrace(const char* path) const {
+    FILE* out = fopen(path, "w");
+    if (!out) return false;
+    fprintf(out, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n");
+    fprintf(out, "  {\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": 1, \"args\": {\"name\": \"main\"}}");
+    for (const TraceEvent& event : trace) {
+        const char* name = event.phase == phaseCount ? "Frame"
+                                                     : GetProfilePhaseName(static_cast<ProfilePhase>(event.phase));
+        double ts = static_cast<double>(event.startNs - captureStartNs) * 1e-3;
+        double dur = static_cast<double>(event.durationNs) * 1e-3;
+        fprintf(out, ",\n  {\"name\": \"%s\", \"cat\": \"%s\", \"ph\": \"X\", \"ts\": %.3f, \"dur\": %.3f, "
+                     "\"pid\": 1, \"tid\": 1}",
+                name, event.phase == phaseCount ? "frame" : "phase", ts, dur);
+    }
+    fprintf(out, "\n]}\n");
+    return fclose(out) == 0;
+}
+
+inline FrameProfiler::Summary FrameProfiler::Summarize(int column) {
+    Summary summary;
+    if (historyCount == 0) return summary;
+    scratch.clear();
+    double total = 0.0;
+    for (int f = 0; f < historyCount; f++) {
+        float value = history[static_cast<size_t>(f * (phaseCount + 1) + column)];
+        scratch.push_back(value);
+        total += value;
+    }
+    summary.averageMs = static_cast<float>(total / historyCount);
+    size_t rank = static_cast<size_t>(0.99 * static_cast<double>(historyCount - 1) + 0.5);
+    std::nth_element(scratch.begin(), scratch.begin() + rank, scratch.end());
+    summary.p99Ms = scratch[rank];
+    return summary;
+}
+
+inline void FrameProfiler::RefreshSummaries() {
+    for (int i = 0; i < phaseCount; i++) summaries[i] = Summarize(i);
+    frameSummary = Summarize(phaseCount);
+}
+
+// Debug panel listing every phase's rolling average and p99 in milliseconds.
+// Row text is formatted into `text`, the caller's per-frame arena; the last row reports
+// its high-water mark next to the simulation's step scratch.
+inline void DrawProfilerOverlay(const FrameProfiler& profiler, FrameArena& text, const FrameArena& simScratch, int x,
+                                int y) {
+    if (!FrameProfiler::enabled || !profiler.overlayVisible) return;
+    const int fontSize = 14;
+    const int rowHeight = 16;
+    const int avgX = x + 170;
+    const int p99X = x + 230;
+    const int rows = FrameProfiler::phaseCount + 4;
+    DrawRectangle(x, y, 290, rows * rowHeight + 12, Fade(BLACK, 0.75f));
+    int rowY = y + 6;
+    DrawText("phase (ms)", x + 8, rowY, fontSize, GRAY);
+    DrawText("avg", avgX, rowY, fontSize, GRAY);
+    DrawText("p99", p99X, rowY, fontSize, GRAY);
+    rowY += rowHeight;
+    const FrameProfiler::Summary& frame = profiler.GetFrameSummary();
+    DrawText("Frame", x + 8, rowY, fontSize, YELLOW);
+    DrawText(text.Format("%.3f", frame.averageMs), avgX, rowY, fontSize, YELLOW);
+    DrawText(text.Format("%.3f", frame.p99Ms), p99X, rowY, fontSize, YELLOW);
+    rowY += rowHeight;
+    for (int i = 0; i < FrameProfiler::phaseCount; i++) {
+        ProfilePhase phase = static_cast<ProfilePhase>(i);
+        const FrameProfiler::Summary& summary = profiler.GetSummary(phase);
+        int indent = GetProfilePhaseDepth(phase) * 12;
+        Color color = indent ? LIGHTGRAY : WHITE;
+        DrawText(GetProfilePhaseName(phase), x + 8 + indent, rowY, fontSize, color);
+        DrawText(text.Format("%.3f", summary.averageMs), avgX, rowY, fontSize, color);
+        DrawText(text.Format("%.3f", summary.p99Ms), p99X, rowY, fontSize, color);
+        rowY += rowHeight;
+    }
+    DrawText(text.Format("arena peak: frame %zu B, sim %zu KB", text.HighWater(), simScratch.HighWater() / 1024), x + 8,
+             rowY, fontSize, GRAY);
+    rowY += rowHeight;
+    if (profiler.Capturing()) DrawText("capturing trace...", x + 8, rowY, fontSize, ORANGE);
+}
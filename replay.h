@@ -0,0 +1,457 @@
+#pragma once
+
+#include "game_sim.h"
+#include "fixed_timestep.h"
+#include <vector>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <chrono>
+
+// =====================================================
+// Input recording and deterministic replay
+// A run is its header (RNG seed, web config, clock, world size) plus one record
+// per PLAYING frame: frame time, aim point, joystick and keyboard direction, fire.
+// Frames are delta-encoded against the previous one: a flags byte says which
+// fields changed, keyboard axes and fire live in the flags themselves, and
+// changed floats are stored as zigzag varints of the difference of their bit
+// patterns, which stays at one or two bytes for the usual frame time jitter.
+// Replaying pushes the records through the same fixed-step loop as the game.
+//
+// File layout (little endian):
+//   "WBRP" u16 version, u64 seed, i32 startingWave, f32 enemyCountMultiplier,
+//   f32 powerUpSpawnIntervalMin, f32 powerUpSpawnIntervalMax, f32 enemyDropChance,
+//   f32 stepsPerSecond, i32 maxStepsPerFrame, f32 worldWidth, f32 worldHeight,
+//   (version 2+) u8 hordeEnabled, f32 hordeCountMultiplier, i32 hordeSpawnPerStep,
+//   i32 hordeAliveCap, then records until the end of the data. Version 1 files
+//   have no horde fields and replay as classic runs.
+// =====================================================
+
+// What the main loop sampled for one PLAYING frame.
+struct RecordedFrame {
+    float delta = 0.f;
+    Vector2 aim = {0.f, 0.f};    // mouse, or the fire touch when one is down
+    Vector2 stick = {0.f, 0.f};  // virtual joystick direction
+    int8_t keyX = 0;             // keyboard direction, each axis in {-1, 0, 1}
+    int8_t keyY = 0;
+    bool fire = false;
+
+    InputFrame ToInput() const {
+        InputFrame input;
+        input.aim = aim;
+        input.move = Vector2Add(stick, {static_cast<float>(keyX), static_cast<float>(keyY)});
+        input.fire = fire;
+        return input;
+    }
+};
+
+struct ReplayHeader {
+    uint64_t seed = 0;
+    int startingWave = 1;
+    float enemyCountMultiplier = 1.f;
+    float powerUpSpawnIntervalMin = 8.f;
+    float powerUpSpawnIntervalMax = 14.f;
+    float enemyDropChance = 0.22f;
+    float stepsPerSecond = 120.f;
+    int maxStepsPerFrame = 8;
+    float worldWidth = 1000.f;
+    float worldHeight = 1000.f;
+    HordeSettings horde;
+};
+
+// Runs one rendered frame's worth of fixed steps; shared by the game loop and replays
+// so both take exactly the same steps.
+inline SimEvents RunSimFrame(GameSim& sim, FixedTimestep& clock, const InputFrame& input, float frameTime) {
+    SimEvents events;
+    int steps = clock.Advance(frameTime);
+    for (int s = 0; s < steps; s++) {
+        events.Accumulate(sim.Step(input, clock.StepSeconds()));
+        if (events.gameOver || events.waveCleared) {
+            clock.Reset();
+            break;
+        }
+    }
+    return events;
+}
+
+class InputRecorder {
+public:
+    static constexpr uint16_t version = 2;
+
+    void Begin(const ReplayHeader& header);
+    void RecordFrame(const RecordedFrame& frame);
+    void RecordUpgrade(int option);
+    // Only writes when the size differs from the last one recorded.
+    void RecordWorldSize(float width, float height);
+
+    // About 30 minutes of play at 60 fps, so recording stays off the heap during a normal run.
+    static constexpr size_t reserveBytes = 2u << 20;
+
+    const std::vector<uint8_t>& Bytes() const { return bytes; }
+    size_t Frames() const { return frames; }
+    bool Save(const char* path) const;
+
+private:
+    std::vector<uint8_t> bytes;
+    RecordedFrame last;
+    float worldWidth = 0.f;
+    float worldHeight = 0.f;
+    size_t frames = 0;
+
+    void PutU32(uint32_t v) { for (int i = 0; i < 4; i++) bytes.push_back(static_cast<uint8_t>(v >> (8 * i))); }
+    void PutU64(uint64_t v) { for (int i = 0; i < 8; i++) bytes.push_back(static_cast<uint8_t>(v >> (8 * i))); }
+    void PutFloat(float f) {
+        uint32_t bits;
+        memcpy(&bits, &f, sizeof(bits));
+        PutU32(bits);
+    }
+    void PutVarint(uint64_t v) {
+        while (v >= 0x80) {
+            bytes.push_back(static_cast<uint8_t>(v | 0x80));
+            v >>= 7;
+        }
+        bytes.push_back(static_cast<uint8_t>(v));
+    }
+    void PutFloatDelta(float prev, float cur) {
+        uint32_t a, b;
+        memcpy(&a, &prev, sizeof(a));
+        memcpy(&b, &cur, sizeof(b));
+        int64_t d = static_cast<int64_t>(b) - static_cast<int64_t>(a);
+        PutVarint((static_cast<uint64_t>(d) << 1) ^ static_cast<uint64_t>(d >> 63));
+    }
+};
+
+struct ReplayRecord {
+    enum class Kind { FRAME, UPGRADE, WORLD_SIZE };
+    Kind kind = Kind::FRAME;
+    RecordedFrame frame;
+    int option = 0;
+    float worldWidth = 0.f;
+    float worldHeight = 0.f;
+};
+
+class InputPlayback {
+public:
+    // Returns false if the data is not a replay this build understands.
+    bool Open(const std::vector<uint8_t>& data);
+    bool Load(const char* path);
+    const ReplayHeader& Header() const { return header; }
+    // Decodes the next record; false at the end of the data or on truncation.
+    bool Next(ReplayRecord& record);
+
+private:
+    std::vector<uint8_t> bytes;
+    size_t cursor = 0;
+    ReplayHeader header;
+    RecordedFrame last;
+
+    bool Get(uint8_t& v) {
+        if (cursor >= bytes.size()) return false;
+        v = bytes[cursor++];
+        return true;
+    }
+    bool GetU32(uint32_t& v) {
+        v = 0;
+        for (int i = 0; i < 4; i++) {
+            uint8_t b;
+            if (!Get(b)) return false;
+            v |= static_cast<uint32_t>(b) << (8 * i);
+        }
+        return true;
+    }
+    bool GetU64(uint64_t& v) {
+        uint32_t lo, hi;
+        if (!GetU32(lo) || !GetU32(hi)) return false;
+        v = lo | (static_cast<uint64_t>(hi) << 32);
+        return true;
+    }
+    bool GetFloat(float& f) {
+        uint32_t bits;
+        if (!GetU32(bits)) return false;
+        memcpy(&f, &bits, sizeof(f));
+        return true;
+    }
+    bool GetVarint(uint64_t& v) {
+        v = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            uint8_t b;
+            if (!Get(b)) return false;
+            v |= static_cast<uint64_t>(b & 0x7F) << shift;
+            if (!(b & 0x80)) return true;
+        }
+        return false;
+    }
+    bool GetFloatDelta(float prev, float& cur) {
+        uint64_t z;
+        if (!GetVarint(z)) return false;
+        int64_t d = static_cast<int64_t>(z >> 1) ^ -static_cast<int64_t>(z & 1);
+        uint32_t a;
+        memcpy(&a, &prev, sizeof(a));
+        uint32_t b = static_cast<uint32_t>(static_cast<int64_t>(a) + d);
+        memcpy(&cur, &b, sizeof(cur));
+        return true;
+    }
+};
+
+// Flags byte of a frame record. Keyboard axes are stored as value + 1 in two bits
+// each; an X field of 3 (never a valid axis) marks a control record instead.
+enum ReplayFlags : uint8_t {
+    REPLAY_DELTA = 1 << 0,
+    REPLAY_AIM = 1 << 1,
+    REPLAY_STICK = 1 << 2,
+    REPLAY_FIRE = 1 << 3,
+    REPLAY_KEY_X_SHIFT = 4,
+    REPLAY_KEY_Y_SHIFT = 6,
+    REPLAY_CONTROL = 3 << 4
+};
+
+enum class ReplayControl : uint8_t { UPGRADE = 1, WORLD_SIZE = 2 };
+
+inline void InputRecorder::Begin(const ReplayHeader& header) {
+    bytes.clear();
+    bytes.reserve(reserveBytes);
+    frames = 0;
+    last = RecordedFrame{};
+    worldWidth = header.worldWidth;
+    worldHeight = header.worldHeight;
+    const char magic[4] = {'W', 'B', 'R', 'P'};
+    bytes.insert(bytes.end(), magic, magic + 4);
+    bytes.push_back(static_cast<uint8_t>(version & 0xFF));
+    bytes.push_back(static_cast<uint8_t>(version >> 8));
+    PutU64(header.seed);
+    PutU32(static_cast<uint32_t>(header.startingWave));
+    PutFloat(header.enemyCountMultiplier);
+    PutFloat(header.powerUpSpawnIntervalMin);
+    PutFloat(header.powerUpSpawnIntervalMax);
+    PutFloat(header.enemyDropChance);
+    PutFloat(header.stepsPerSecond);
+    PutU32(static_cast<uint32_t>(header.maxStepsPerFrame));
+    PutFloat(header.worldWidth);
+    PutFloat(header.worldHeight);
+    bytes.push_back(header.horde.enabled ? 1 : 0);
+    PutFloat(header.horde.countMultiplier);
+    PutU32(static_cast<uint32_t>(header.horde.spawnPerStep));
+    PutU32(static_cast<uint32_t>(header.horde.aliveCap));
+}
+
+inline void InputRecorder::RecordFrame(const RecordedFrame& frame) {
+    uint8_t flags = static_cast<uint8_t>(((frame.keyX + 1) << REPLAY_KEY_X_SHIFT) |
+                                         ((frame.keyY + 1) << REPLAY_KEY_Y_SHIFT));
+    bool deltaChanged = memcmp(&frame.delta, &last.delta, sizeof(float)) != 0;
+    bool aimChanged = memcmp(&frame.aim, &last.aim, sizeof(Vector2)) != 0;
+    bool stickChanged = memcmp(&frame.stick, &last.stick, sizeof(Vector2)) != 0;
+    if (deltaChanged) flags |= REPLAY_DELTA;
+    if (aimChanged) flags |= REPLAY_AIM;
+    if (stickChanged) flags |= REPLAY_STICK;
+    if (frame.fire) flags |= REPLAY_FIRE;
+    bytes.push_back(flags);
+    if (deltaChanged) PutFloatDelta(last.delta, frame.delta);
+    if (aimChanged) {
+        PutFloatDelta(last.aim.x, frame.aim.x);
+        PutFloatDelta(last.aim.y, frame.aim.y);
+    }
+    if (stickChanged) {
+        PutFloatDelta(last.stick.x, frame.stick.x);
+        PutFloatDelta(last.stick.y, frame.stick.y);
+    }
+    last = frame;
+    frames++;
+}
+
+inline void InputRecorder::RecordUpgrade(int option) {
+    bytes.push_back(REPLAY_CONTROL);
+    bytes.push_back(static_cast<uint8_t>(ReplayControl::UPGRADE));
+    bytes.push_back(static_cast<uint8_t>(option));
+}
+
+inline void InputRecorder::RecordWorldSize(float width, float height) {
+    if (width == worldWidth && height == worldHeight) return;
+    worldWidth = width;
+    worldHeight = height;
+    bytes.push_back(REPLAY_CONTROL);
+    bytes.push_back(static_cast<uint8_t>(ReplayControl::WORLD_SIZE));
+    PutFloat(width);
+    PutFloat(height);
+}
+
+inline bool InputRecorder::Save(const char* path) const {
+    FILE* file = fopen(path, "wb");
+    if (!file) return false;
+    bool ok = fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+    return fclose(file) == 0 && ok;
+}
+
+inline bool InputPlayback::Open(const std::vector<uint8_t>& data) {
+    bytes = data;
+    cursor = 0;
+    last = RecordedFrame{};
+    if (bytes.size() < 6 || memcmp(bytes.data(), "WBRP", 4) != 0) return false;
+    cursor = 4;
+    uint8_t lo, hi;
+    Get(lo);
+    Get(hi);
+    int fileVersion = lo | (hi << 8);
+    if (fileVersion < 1 || fileVersion > InputRecorder::version) return false;
+    uint32_t wave = 0, maxSteps = 0;
+    bool ok = GetU64(header.seed) && GetU32(wave) &&
+              GetFloat(header.enemyCountMultiplier) && GetFloat(header.powerUpSpawnIntervalMin) &&
+              GetFloat(header.powerUpSpawnIntervalMax) && GetFloat(header.enemyDropChance) &&
+              GetFloat(header.stepsPerSecond) && GetU32(maxSteps) &&
+              GetFloat(header.worldWidth) && GetFloat(header.worldHeight);
+    header.startingWave = static_cast<int>(wave);
+    header.maxStepsPerFrame = static_cast<int>(maxSteps);
+    header.horde = HordeSettings{};
+    if (ok && fileVersion >= 2) {
+        uint8_t enabled = 0;
+        uint32_t spawnPerStep = 0, aliveCap = 0;
+        ok = Get(enabled) && GetFloat(header.horde.countMultiplier) && GetU32(spawnPerStep) && GetU32(aliveCap);
+        header.horde.enabled = enabled != 0;
+        header.horde.spawnPerStep = static_cast<int>(spawnPerStep);
+        header.horde.aliveCap = static_cast<int>(aliveCap);
+    }
+    return ok;
+}
+
+inline bool InputPlayback::Load(const char* path) {
+    FILE* file = fopen(path, "rb");
+    if (!file) return false;
+    std::vector<uint8_t> data;
+    uint8_t chunk[4096];
+    size_t got;
+    while ((got = fread(chunk, 1, sizeof(chunk), file)) > 0) data.insert(data.end(), chunk, chunk + got);
+    fclose(file);
+    return Open(data);
+}
+
+inline bool InputPlayback::Next(ReplayRecord& record) {
+    uint8_t flags;
+    if (!Get(flags)) return false;
+    if ((flags & REPLAY_CONTROL) == REPLAY_CONTROL) {
+        uint8_t control;
+        if (!Get(control)) return false;
+        if (control == static_cast<uint8_t>(ReplayControl::UPGRADE)) {
+            uint8_t option;
+            if (!Get(option)) return false;
+            record.kind = ReplayRecord::Kind::UPGRADE;
+            record.option = option;
+            return true;
+        }
+        if (control == static_cast<uint8_t>(ReplayControl::WORLD_SIZE)) {
+            record.kind = ReplayRecord::Kind::WORLD_SIZE;
+            return GetFloat(record.worldWidth) && GetFloat(record.worldHeight);
+        }
+        return false;
+    }
+    RecordedFrame frame = last;
+    frame.keyX = static_cast<int8_t>(((flags >> REPLAY_KEY_X_SHIFT) & 3) - 1);
+    frame.keyY = static_cast<int8_t>(((flags >> REPLAY_KEY_Y_SHIFT) & 3) - 1);
+    frame.fire = (flags & REPLAY_FIRE) != 0;
+    if ((flags & REPLAY_DELTA) && !GetFloatDelta(last.delta, frame.delta)) return false;
+    if ((flags & REPLAY_AIM) &&
+        !(GetFloatDelta(last.aim.x, frame.aim.x) && GetFloatDelta(last.aim.y, frame.aim.y))) return false;
+    if ((flags & REPLAY_STICK) &&
+        !(GetFloatDelta(last.stick.x, frame.stick.x) && GetFloatDelta(last.stick.y, frame.stick.y))) return false;
+    last = frame;
+    record.kind = ReplayRecord::Kind::FRAME;
+    record.frame = frame;
+    return true;
+}
+
+// Header for a run that GameSim::StartRun just began, with the current web config.
+inline ReplayHeader MakeReplayHeader(const GameSim& sim, const FixedTimestep& clock) {
+    ReplayHeader header;
+    header.seed = sim.rng.SeedValue();
+    header.startingWave = startingWaveOverride;
+    header.enemyCountMultiplier = enemyCountMultiplier;
+    header.powerUpSpawnIntervalMin = powerUpSpawnIntervalMin;
+    header.powerUpSpawnIntervalMax = powerUpSpawnIntervalMax;
+    header.enemyDropChance = enemyDropChance;
+    header.stepsPerSecond = clock.StepsPerSecond();
+    header.maxStepsPerFrame = clock.MaxStepsPerFrame();
+    header.worldWidth = sim.worldWidth;
+    header.worldHeight = sim.worldHeight;
+    header.horde = sim.horde;
+    return header;
+}
+
+struct ReplayStats {
+    size_t frames = 0;
+    size_t upgrades = 0;
+    double simulatedSeconds = 0.0;
+    bool gameOver = false;
+};
+
+// Replays a recording as fast as possible. onFrame(frameIndex, sim) runs after every
+// frame record, e.g. to collect StateChecksum(). The web config globals are swapped
+// for the recorded values and restored afterwards.
+template <typename FrameFn>
+inline void RunReplay(InputPlayback& playback, ReplayStats& stats, FrameFn onFrame) {
+    const ReplayHeader& header = playback.Header();
+    int savedWave = startingWaveOverride;
+    float savedCount = enemyCountMultiplier, savedMin = powerUpSpawnIntervalMin;
+    float savedMax = powerUpSpawnIntervalMax, savedDrop = enemyDropChance;
+    startingWaveOverride = header.startingWave;
+    enemyCountMultiplier = header.enemyCountMultiplier;
+    powerUpSpawnIntervalMin = header.powerUpSpawnIntervalMin;
+    powerUpSpawnIntervalMax = header.powerUpSpawnIntervalMax;
+    enemyDropChance = header.enemyDropChance;
+
+    GameSim sim;
+    sim.SetWorldSize(header.worldWidth, header.worldHeight);
+    sim.horde = header.horde;
+    sim.StartRun(header.seed);
+    FixedTimestep clock(header.stepsPerSecond, header.maxStepsPerFrame);
+    stats = ReplayStats{};
+
+    ReplayRecord record;
+    while (playback.Next(record)) {
+        switch (record.kind) {
+            case ReplayRecord::Kind::FRAME: {
+                SimEvents events = RunSimFrame(sim, clock, record.frame.ToInput(), record.frame.delta);
+                stats.simulatedSeconds += record.frame.delta;
+                if (events.gameOver) stats.gameOver = true;
+                onFrame(stats.frames, sim);
+                stats.frames++;
+            } break;
+            case ReplayRecord::Kind::UPGRADE:
+                sim.ApplyUpgrade(record.option);
+                clock.Reset();
+                stats.upgrades++;
+                break;
+            case ReplayRecord::Kind::WORLD_SIZE:
+                sim.SetWorldSize(record.worldWidth, record.worldHeight);
+                break;
+        }
+    }
+
+    startingWaveOverride = savedWave;
+    enemyCountMultiplier = savedCount;
+    powerUpSpawnIntervalMin = savedMin;
+    powerUpSpawnIntervalMax = savedMax;
+    enemyDropChance = savedDrop;
+}
+
+// Command-line replay: `--replay <file> [checksums.txt]`. Writes "frame checksum"
+// lines (to stdout without a path) and a timing summary to stderr.
+inline int ReplayMain(const char* path, const char* checksumPath) {
+    InputPlayback playback;
+    if (!playback.Load(path)) {
+        fprintf(stderr, "replay: cannot read %s\n", path);
+        return 1;
+    }
+    FILE* out = checksumPath ? fopen(checksumPath, "w") : stdout;
+    if (!out) {
+        fprintf(stderr, "replay: cannot write %s\n", checksumPath);
+        return 1;
+    }
+    ReplayStats stats;
+    auto start = std::chrono::steady_clock::now();
+    RunReplay(playback, stats, [&](size_t frame, const GameSim& sim) {
+        fprintf(out, "%zu %016llx\n", frame, static_cast<unsigned long long>(sim.StateChecksum()));
+    });
+    double wallMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    if (out != stdout) fclose(out);
+    fprintf(stderr, "replay: %zu frames, %zu upgrades, %.1f s simulated in %.1f ms%s\n",
+            stats.frames, stats.upgrades, stats.simulatedSeconds, wallMs, stats.gameOver ? " (game over)" : "");
+    return 0;
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstdint>
+
+// =====================================================
+// Counter-based random streams
+// Value n of a stream is a pure function of (seed, stream id, n): a SplitMix64
+// finalizer applied to a per-stream Weyl sequence. Streams never share state, so
+// each subsystem (or each job of a parallel spawner) can draw independently and a
+// run is reproduced exactly from its seed. At(n) reads any position without
+// advancing, for workers that need to index straight into a stream.
+// =====================================================
+
+inline uint64_t SplitMix64(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+class RngStream {
+public:
+    RngStream() : RngStream(0, 0) {}
+    RngStream(uint64_t seed, uint64_t stream)
+        : key(SplitMix64(seed ^ SplitMix64(stream + 0x9E3779B97F4A7C15ull))),
+          gamma(SplitMix64(stream ^ 0xD1B54A32D192ED03ull) | 1ull) {}
+
+    uint64_t At(uint64_t index) const { return SplitMix64(key + (index + 1) * gamma); }
+    uint64_t NextU64() { return At(counter++); }
+    uint32_t NextU32() { return static_cast<uint32_t>(NextU64() >> 32); }
+
+    // Inclusive range with GetRandomValue's semantics (arguments may come in either order).
+    int Range(int min, int max) {
+        if (min > max) {
+            int t = min;
+            min = max;
+            max = t;
+        }
+        uint64_t span = static_cast<uint64_t>(static_cast<int64_t>(max) - min) + 1;
+        return static_cast<int>(min + static_cast<int64_t>((NextU32() * span) >> 32));
+    }
+
+    // Uniform in [0, 1).
+    float Unit() { return static_cast<float>(NextU32() >> 8) * (1.f / 16777216.f); }
+
+    uint64_t Counter() const { return counter; }
+    void Skip(uint64_t count) { counter += count; }
+
+private:
+    uint64_t key;
+    uint64_t gamma;
+    uint64_t counter = 0;
+};
+
+// One stream per gameplay subsystem, all derived from a single run seed.
+enum class RngStreamId : uint64_t {
+    WAVE_SPAWN = 1,    // spawn sides, positions and enemy types
+    ENEMY_TRAITS = 2,  // per-enemy behaviour phase
+    DROPS = 3,         // kill drops and their power-up type
+    FIELD_POWERUPS = 4 // timed field power-up interval, placement and type
+};
+
+class GameRng {
+public:
+    explicit GameRng(uint64_t seed = 0) { Seed(seed); }
+
+    void Seed(uint64_t value) {
+        seed = value;
+        waveSpawn = RngStream(seed, static_cast<uint64_t>(RngStreamId::WAVE_SPAWN));
+        enemyTraits = RngStream(seed, static_cast<uint64_t>(RngStreamId::ENEMY_TRAITS));
+        drops = RngStream(seed, static_cast<uint64_t>(RngStreamId::DROPS));
+        fieldPowerUps = RngStream(seed, static_cast<uint64_t>(RngStreamId::FIELD_POWERUPS));
+    }
+    uint64_t SeedValue() const { return seed; }
+
+    RngStream waveSpawn;
+    RngStream enemyTraits;
+    RngStream drops;
+    RngStream fieldPowerUps;
+
+private:
+    uint64_t seed = 0;
+};
@@ -0,0 +1,146 @@
+#pragma once
+
+#include "fast_math.h"
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+// =====================================================
+// Game-state snapshots
+// GameSim::SaveSnapshot packs the state a step reads into one versioned binary blob,
+// and RestoreSnapshot reads it back. The blob is fixed-layout, so its size follows
+// from the counts in the header and a restore can check it before changing anything.
+//
+// The run-wide values are stored exactly. These are the player, wave counters,
+// timers, multipliers, horde settings, and the RNG seed and stream counters.
+// Per-entity records are packed:
+// - Positions are 16-bit fixed point at 1/8 px.
+// - Enemies store an archetype index. Speed and radius come back from the archetype
+//   table at the saved wave.
+// - Enemy facings are 8-bit and sway timers 16-bit. Flash timers are whole milliseconds.
+// - Enemy health is saturated at 65535.
+// - Power-ups and timed effects store only their PowerUpType.
+// - Bullet velocities are stored exactly, so shots keep their heading.
+// A restored sim therefore plays on like the saved one, though not bit for bit.
+// Previous positions are not stored. A restore sets them to the current ones, so the
+// first frame after it renders without interpolation. Flow-field walls are level
+// data, not run state, and are not saved; restoring into a different world size clears
+// them, as SetWorldSize does.
+//
+// Positions past +-4096 px are clamped to that edge. Enemies spawn and get knocked back
+// outside the world, so ones far off-screen in a large world come back nearer to it.
+// Save refuses worlds wider or taller than the q16 range, since none of their blobs
+// could be restored. Restore rejects world sizes that are not finite, not positive or
+// past that range. It also rejects player, wave and horde values no run reaches, such
+// as health above max or an alive cap past HordeSettings::maxAliveCap.
+//
+// Layout (little endian):
+//   "WBSS" u16 version, f32 worldWidth, f32 worldHeight,
+//   player: f32 x, f32 y, i32 health, f32 speed, f32 baseSpeed, f32 radius,
+//     i32 baseMaxHealth, i32 maxHealth, i32 shieldCharges, f32 shieldTimer,
+//   i32 currentWave, i32 enemiesRemaining, i32 pendingSpawns, i32 pendingWave,
+//   u8 gameOver, f32 fireTimer, f32 powerUpSpawnTimer, f32 permanentHealthMultiplier,
+//   f32 permanentFireRateMultiplier, f32 permanentDamageMultiplier,
+//   u8 hordeEnabled, f32 hordeCountMultiplier, i32 hordeSpawnPerStep, i32 hordeAliveCap,
+//   u64 rngSeed, u64 counters (waveSpawn, enemyTraits, drops, fieldPowerUps),
+//   u64 runsStarted, i32 enemyStatsWave,
+//   u32 enemies, u32 bullets, u32 powerUps, u32 explosions, u32 effects, then the records:
+//   enemy (12 B): u8 archetype, u8 flashMs, q16 x, q16 y, i8 facingX, i8 facingY,
+//     u16 timer (fraction of the sway period), u16 health
+//   bullet (25 B): u8 type, q16 x, q16 y, f32 vx, f32 vy, i32 damage, u8 r, g, b, a,
+//     f32 explosionRadius
+//   power-up (5 B): u8 type, q16 x, q16 y
+//   explosion (21 B): q16 x, q16 y, f32 radius, f32 lifetime, f32 elapsed, i32 damage,
+//     u8 applied
+//   effect (5 B), soonest deadline first: u8 type, f32 remaining
+// =====================================================
+
+constexpr uint16_t snapshotVersion = 1;
+constexpr float snapshotPositionScale = 8.f;  // q16 units per pixel; covers +-4096 px
+constexpr float snapshotMaxCoord = 32767.f / snapshotPositionScale;  // also the largest world size restored
+constexpr size_t snapshotHeaderBytes = 4 + 2 + 2 * 4 + 10 * 4 + 4 * 4 + 1 + 5 * 4 + 1 + 3 * 4 + 6 * 8 + 4 + 5 * 4;
+constexpr size_t snapshotEnemyBytes = 12;
+constexpr size_t snapshotBulletBytes = 25;
+constexpr size_t snapshotPowerUpBytes = 5;
+constexpr size_t snapshotExplosionBytes = 21;
+constexpr size_t snapshotEffectBytes = 5;
+
+// Rounds to the nearest integer in [lo, hi]; NaN maps to lo.
+inline int QuantizeClamped(float value, float lo, float hi) {
+    value = value > lo ? value : lo;
+    value = value < hi ? value : hi;
+    return static_cast<int>(FastRoundNearest(value));
+}
+
+// Writes into a buffer already sized for the whole snapshot.
+class SnapshotWriter {
+public:
+    explicit SnapshotWriter(uint8_t* out) : cursor(out) {}
+
+    void PutU8(uint8_t v) { *cursor++ = v; }
+    void PutU16(uint16_t v) {
+        cursor[0] = static_cast<uint8_t>(v);
+        cursor[1] = static_cast<uint8_t>(v >> 8);
+        cursor += 2;
+    }
+    void PutU32(uint32_t v) {
+        for (int i = 0; i < 4; i++) cursor[i] = static_cast<uint8_t>(v >> (8 * i));
+        cursor += 4;
+    }
+    void PutU64(uint64_t v) {
+        for (int i = 0; i < 8; i++) cursor[i] = static_cast<uint8_t>(v >> (8 * i));
+        cursor += 8;
+    }
+    void PutI32(int v) { PutU32(static_cast<uint32_t>(v)); }
+    void PutFloat(float f) {
+        uint32_t bits;
+        memcpy(&bits, &f, sizeof(bits));
+        PutU32(bits);
+    }
+    void PutCoord(float v) {
+        PutU16(static_cast<uint16_t>(QuantizeClamped(v * snapshotPositionScale, -32768.f, 32767.f)));
+    }
+
+    const uint8_t* Cursor() const { return cursor; }
+
+private:
+    uint8_t* cursor;
+};
+
+// Reads a snapshot whose size was checked up front, so the getters never run past the end.
+class SnapshotReader {
+public:
+    explicit SnapshotReader(const uint8_t* data) : cursor(data) {}
+
+    uint8_t GetU8() { return *cursor++; }
+    uint16_t GetU16() {
+        uint16_t v = static_cast<uint16_t>(cursor[0] | (cursor[1] << 8));
+        cursor += 2;
+        return v;
+    }
+    uint32_t GetU32() {
+        uint32_t v = 0;
+        for (int i = 0; i < 4; i++) v |= static_cast<uint32_t>(cursor[i]) << (8 * i);
+        cursor += 4;
+        return v;
+    }
+    uint64_t GetU64() {
+        uint64_t lo = GetU32();
+        uint64_t hi = GetU32();
+        return lo | (hi << 32);
+    }
+    int GetI32() { return static_cast<int>(GetU32()); }
+    float GetFloat() {
+        uint32_t bits = GetU32();
+        float f;
+        memcpy(&f, &bits, sizeof(f));
+        return f;
+    }
+    float GetCoord() { return static_cast<float>(static_cast<int16_t>(GetU16())) * (1.f / snapshotPositionScale); }
+
+    const uint8_t* Cursor() const { return cursor; }
+    void Skip(size_t bytes) { cursor += bytes; }
+
+private:
+    const uint8_t* cursor;
+};
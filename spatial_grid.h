@@ -0,0 +1,132 @@
+#pragma once
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+// =====================================================
+// Uniform grid broad phase
+// Items are bucketed by cell with a counting sort, so a rebuild is O(items + cells)
+// and items inside a cell keep ascending index order. Positions outside the grid
+// are clamped to the border cells; queries clamp the same way, so a query box
+// always sees every item whose position lies inside it.
+// =====================================================
+class SpatialGrid {
+public:
+    void Reset(float originX, float originY, float width, float height, float cellSize) {
+        this->originX = originX;
+        this->originY = originY;
+        this->cellSize = cellSize > 1.f ? cellSize : 1.f;
+        invCellSize = 1.f / this->cellSize;
+        cols = std::max(1, static_cast<int>(std::ceil(width * invCellSize)));
+        rows = std::max(1, static_cast<int>(std::ceil(height * invCellSize)));
+        cellStart.assign(static_cast<size_t>(cols * rows + 1), 0);
+        items.clear();
+        itemCell.clear();
+    }
+
+    // Sizes the item arrays (and, after Reset, the build cursor) so Build never
+    // reallocates for up to `count` items.
+    void Reserve(int count) {
+        items.reserve(static_cast<size_t>(count));
+        itemCell.reserve(static_cast<size_t>(count));
+        cursor.reserve(cellStart.size());
+    }
+
+    // positionOf(i) must return something with .x/.y for i in [0, count).
+    template <typename PositionFn>
+    void Build(int count, PositionFn positionOf) {
+        std::fill(cellStart.begin(), cellStart.end(), 0);
+        itemCell.resize(static_cast<size_t>(count));
+        items.resize(static_cast<size_t>(count));
+        for (int i = 0; i < count; i++) {
+            auto p = positionOf(i);
+            int cell = CellIndex(CellX(p.x), CellY(p.y));
+            itemCell[i] = cell;
+            cellStart[cell + 1]++;
+        }
+        for (int c = 0; c < cols * rows; c++) cellStart[c + 1] += cellStart[c];
+        cursor.assign(cellStart.begin(), cellStart.end() - 1);
+        for (int i = 0; i < count; i++) items[cursor[itemCell[i]]++] = i;
+    }
+
+    // Calls visit(index) for every item bucketed in a cell overlapping the box.
+    // Candidates are conservative; the caller does the exact test.
+    template <typename VisitFn>
+    void Query(float minX, float minY, float maxX, float maxY, VisitFn visit) const {
+        int x0 = CellX(minX), x1 = CellX(maxX);
+        int y0 = CellY(minY), y1 = CellY(maxY);
+        for (int cy = y0; cy <= y1; cy++) {
+            for (int cx = x0; cx <= x1; cx++) {
+                int cell = CellIndex(cx, cy);
+                for (int k = cellStart[cell]; k < cellStart[cell + 1]; k++) visit(items[k]);
+            }
+        }
+    }
+
+    // Like Query, but visits at most perCell items from each cell, so the cost per query
+    // stays bounded however crowded the cells get. A crowded cell is sampled as a window
+    // of perCell items that starts `rotation` items in (wrapping), so callers passing
+    // different rotations see different members of the crowd instead of the same few.
+    template <typename VisitFn>
+    void QueryCapped(float minX, float minY, float maxX, float maxY, int perCell, unsigned rotation, VisitFn visit) const {
+        int x0 = CellX(minX), x1 = CellX(maxX);
+        int y0 = CellY(minY), y1 = CellY(maxY);
+        for (int cy = y0; cy <= y1; cy++) {
+            for (int cx = x0; cx <= x1; cx++) {
+                int cell = CellIndex(cx, cy);
+                int begin = cellStart[cell];
+                int count = cellStart[cell + 1] - begin;
+                if (count <= perCell) {
+                    for (int k = 0; k < count; k++) visit(items[begin + k]);
+                    continue;
+                }
+                int k = static_cast<int>(rotation % static_cast<unsigned>(count));
+                for (int n = 0; n < perCell; n++) {
+                    visit(items[begin + k]);
+                    if (++k == count) k = 0;
+                }
+            }
+        }
+    }
+
+    // Calls visit(begin, end) with the bucket slot range of every cell overlapping the box,
+    // for callers that test a cell's items as one batch. ItemAt maps a slot to its item.
+    template <typename VisitFn>
+    void QueryRanges(float minX, float minY, float maxX, float maxY, VisitFn visit) const {
+        int x0 = CellX(minX), x1 = CellX(maxX);
+        int y0 = CellY(minY), y1 = CellY(maxY);
+        for (int cy = y0; cy <= y1; cy++) {
+            for (int cx = x0; cx <= x1; cx++) {
+                int cell = CellIndex(cx, cy);
+                if (cellStart[cell] < cellStart[cell + 1]) visit(cellStart[cell], cellStart[cell + 1]);
+            }
+        }
+    }
+    int ItemAt(int slot) const { return items[static_cast<size_t>(slot)]; }
+
+    int Columns() const { return cols; }
+    int Rows() const { return rows; }
+
+private:
+    float originX = 0.f;
+    float originY = 0.f;
+    float cellSize = 64.f;
+    float invCellSize = 1.f / 64.f;
+    int cols = 1;
+    int rows = 1;
+    std::vector<int> cellStart;
+    std::vector<int> items;
+    std::vector<int> itemCell;
+    std::vector<int> cursor;
+
+    int CellX(float x) const {
+        int cx = static_cast<int>(std::floor((x - originX) * invCellSize));
+        return cx < 0 ? 0 : (cx >= cols ? cols - 1 : cx);
+    }
+    int CellY(float y) const {
+        int cy = static_cast<int>(std::floor((y - originY) * invCellSize));
+        return cy < 0 ? 0 : (cy >= rows ? rows - 1 : cy);
+    }
+    int CellIndex(int cx, int cy) const { return cy * cols + cx; }
+};
@@ -0,0 +1,183 @@
+#pragma once
+
+#include "raylib.h"
+#include "fast_math.h"
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+// =====================================================
+// Swept-circle projectile tests
+// A projectile hits a circle if any point of its last step (previous position to
+// current position) comes within the two radii, so a fast bullet can't step over a
+// small enemy however long the tick. ProjectileSweeps holds the steps in the bullet
+// grid's slot order as flat streams, so one call tests a run of bullets from the same
+// cell against one circle, 4 or 8 at a time on SSE2/AVX2. The SIMD and scalar tests
+// run the same float operations in the same order and agree on every hit.
+// =====================================================
+
+// Index of the lowest set bit; mask must be non-zero.
+inline int LowestSetBit(uint32_t mask) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctz(mask);
+#else
+    int bit = 0;
+    while (!(mask & 1u)) {
+        mask >>= 1;
+        bit++;
+    }
+    return bit;
+#endif
+}
+
+// Segment a -> b carrying radius `radius` against the circle (center, centerRadius).
+inline bool SweptCircleHit(Vector2 a, Vector2 b, float radius, Vector2 center, float centerRadius) {
+    float dx = b.x - a.x;
+    float dy = b.y - a.y;
+    float lengthSq = dx * dx + dy * dy;
+    float invLengthSq = lengthSq > 0.f ? 1.f / lengthSq : 0.f;
+    float wx = center.x - a.x;
+    float wy = center.y - a.y;
+    float t = (wx * dx + wy * dy) * invLengthSq;
+    t = t > 0.f ? t : 0.f;
+    t = t < 1.f ? t : 1.f;
+    float px = wx - dx * t;
+    float py = wy - dy * t;
+    float reach = radius + centerRadius;
+    return px * px + py * py <= reach * reach;
+}
+
+class ProjectileSweeps {
+public:
+    // Widest SIMD batch Hits tests at once; the streams keep this much padding.
+    static constexpr size_t batchWidth = 8;
+    static constexpr size_t maskWidth = 32;  // most slots one Hits call reports
+
+    void Reserve(size_t count) {
+        size_t padded = count + batchWidth;
+        startX.reserve(padded);
+        startY.reserve(padded);
+        stepX.reserve(padded);
+        stepY.reserve(padded);
+        invLengthSq.reserve(padded);
+        radius.reserve(padded);
+    }
+
+    // Sizes the streams for `count` slots, to be filled with Set; the padding slots after
+    // them never hit anything.
+    void Resize(size_t count) {
+        size_t padded = count + batchWidth;
+        startX.resize(padded);
+        startY.resize(padded);
+        stepX.resize(padded);
+        stepY.resize(padded);
+        invLengthSq.resize(padded);
+        radius.resize(padded);
+        for (size_t k = count; k < padded; k++) Set(k, {0.f, 0.f}, {0.f, 0.f}, -1e30f);
+        size = count;
+    }
+
+    void Set(size_t slot, Vector2 from, Vector2 to, float projectileRadius) {
+        float dx = to.x - from.x;
+        float dy = to.y - from.y;
+        float lengthSq = dx * dx + dy * dy;
+        startX[slot] = from.x;
+        startY[slot] = from.y;
+        stepX[slot] = dx;
+        stepY[slot] = dy;
+        invLengthSq[slot] = lengthSq > 0.f ? 1.f / lengthSq : 0.f;
+        radius[slot] = projectileRadius;
+    }
+
+    size_t Size() const { return size; }
+
+    bool Hit(size_t slot, Vector2 center, float centerRadius) const;
+    // Bit b set if slot first + b hits, for b < count (count <= maskWidth).
+    uint32_t Hits(size_t first, size_t count, Vector2 center, float centerRadius) const;
+    // Calls visit(slot) for every slot in [first, first + count) that hits, in ascending
+    // order. Tests a whole grid cell per Hits call where it fits in the mask, then jumps
+    // straight from one set bit to the next, so neither short batches nor sparse hits
+    // cost a mispredicted branch per slot.
+    template <typename Visit>
+    void ForEachHit(size_t first, size_t count, Vector2 center, float centerRadius, Visit&& visit) const;
+
+private:
+    std::vector<float> startX, startY;
+    std::vector<float> stepX, stepY;
+    std::vector<float> invLengthSq;
+    std::vector<float> radius;
+    size_t size = 0;
+};
+
+inline bool ProjectileSweeps::Hit(size_t slot, Vector2 center, float centerRadius) const {
+    float wx = center.x - startX[slot];
+    float wy = center.y - startY[slot];
+    float t = (wx * stepX[slot] + wy * stepY[slot]) * invLengthSq[slot];
+    t = t > 0.f ? t : 0.f;
+    t = t < 1.f ? t : 1.f;
+    float px = wx - stepX[slot] * t;
+    float py = wy - stepY[slot] * t;
+    float reach = radius[slot] + centerRadius;
+    // Padding slots carry a huge negative radius, ruled out by the sign (its square
+    // would overflow to infinity and pass the distance test).
+    return reach >= 0.f && px * px + py * py <= reach * reach;
+}
+
+inline uint32_t ProjectileSweeps::Hits(size_t first, size_t count, Vector2 center, float centerRadius) const {
+    uint32_t mask = 0;
+    size_t b = 0;
+#if defined(FAST_MATH_AVX2)
+    for (; b < count; b += 8) {
+        size_t k = first + b;
+        __m256 wx = _mm256_sub_ps(_mm256_set1_ps(center.x), _mm256_loadu_ps(&startX[k]));
+        __m256 wy = _mm256_sub_ps(_mm256_set1_ps(center.y), _mm256_loadu_ps(&startY[k]));
+        __m256 dx = _mm256_loadu_ps(&stepX[k]);
+        __m256 dy = _mm256_loadu_ps(&stepY[k]);
+        __m256 t = _mm256_mul_ps(_mm256_add_ps(_mm256_mul_ps(wx, dx), _mm256_mul_ps(wy, dy)), _mm256_loadu_ps(&invLengthSq[k]));
+        t = _mm256_max_ps(t, _mm256_setzero_ps());
+        t = _mm256_min_ps(t, _mm256_set1_ps(1.f));
+        __m256 px = _mm256_sub_ps(wx, _mm256_mul_ps(dx, t));
+        __m256 py = _mm256_sub_ps(wy, _mm256_mul_ps(dy, t));
+        __m256 reach = _mm256_add_ps(_mm256_loadu_ps(&radius[k]), _mm256_set1_ps(centerRadius));
+        __m256 inside = _mm256_cmp_ps(_mm256_add_ps(_mm256_mul_ps(px, px), _mm256_mul_ps(py, py)),
+                                      _mm256_mul_ps(reach, reach), _CMP_LE_OQ);
+        __m256 valid = _mm256_cmp_ps(reach, _mm256_setzero_ps(), _CMP_GE_OQ);
+        mask |= static_cast<uint32_t>(_mm256_movemask_ps(_mm256_and_ps(inside, valid))) << b;
+    }
+#elif defined(FAST_MATH_SSE2)
+    for (; b < count; b += 4) {
+        size_t k = first + b;
+        __m128 wx = _mm_sub_ps(_mm_set1_ps(center.x), _mm_loadu_ps(&startX[k]));
+        __m128 wy = _mm_sub_ps(_mm_set1_ps(center.y), _mm_loadu_ps(&startY[k]));
+        __m128 dx = _mm_loadu_ps(&stepX[k]);
+        __m128 dy = _mm_loadu_ps(&stepY[k]);
+        __m128 t = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(wx, dx), _mm_mul_ps(wy, dy)), _mm_loadu_ps(&invLengthSq[k]));
+        t = _mm_max_ps(t, _mm_setzero_ps());
+        t = _mm_min_ps(t, _mm_set1_ps(1.f));
+        __m128 px = _mm_sub_ps(wx, _mm_mul_ps(dx, t));
+        __m128 py = _mm_sub_ps(wy, _mm_mul_ps(dy, t));
+        __m128 reach = _mm_add_ps(_mm_loadu_ps(&radius[k]), _mm_set1_ps(centerRadius));
+        __m128 inside = _mm_cmple_ps(_mm_add_ps(_mm_mul_ps(px, px), _mm_mul_ps(py, py)), _mm_mul_ps(reach, reach));
+        __m128 valid = _mm_cmpge_ps(reach, _mm_setzero_ps());
+        mask |= static_cast<uint32_t>(_mm_movemask_ps(_mm_and_ps(inside, valid))) << b;
+    }
+#endif
+    for (; b < count; b++) {
+        if (Hit(first + b, center, centerRadius)) mask |= 1u << b;
+    }
+    // Lanes past `count` belong to the next cell (or padding); drop them.
+    return count >= 32 ? mask : mask & ((1u << count) - 1u);
+}
+
+template <typename Visit>
+inline void ProjectileSweeps::ForEachHit(size_t first, size_t count, Vector2 center, float centerRadius,
+                                         Visit&& visit) const {
+    for (size_t done = 0; done < count; done += maskWidth) {
+        size_t width = count - done < maskWidth ? count - done : maskWidth;
+        uint32_t hits = Hits(first + done, width, center, centerRadius);
+        while (hits != 0) {
+            visit(first + done + static_cast<size_t>(LowestSetBit(hits)));
+            hits &= hits - 1u;
+        }
+    }
+}